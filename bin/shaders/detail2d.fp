@@ -15,12 +15,15 @@ varying vec3 LightHalf[MAX_LIGHTS];
 
 uniform sampler2D Texture;
 uniform sampler2D TextureNrm;
+uniform sampler2D LightMap; // baked item lights
+varying vec2 LightMapCoord;
 /*uniform sampler2D TextureDisp;*/
 /*uniform sampler2D TextureSpec;*/
 /*uniform sampler2D TextureFade;*/
 uniform vec3 MaterialAmbient;
 uniform vec4 MaterialDiffuse;
 uniform vec3 MaterialSpecular;
+uniform vec3 MaterialEmissive = vec3(0.0, 0.0, 0.0); // unlit tint
 uniform float MaterialShininess = 20.0;
 
 varying vec3 Position;
@@ -36,9 +39,18 @@ varying vec3 Eye;
 
 void main(void)
 {
+    // unlit tiles (parallax chunks) come with u shifted by 2
+    bool unlit = Wrap.x > 1.5;
+    vec2 uv = unlit ? vec2(Wrap.x - 2.0, Wrap.y) : Wrap;
+    vec4 base = texture2D(Texture, uv);
+
+    if(unlit) {
+        gl_FragColor = vec4(base.rgb * MaterialEmissive, base.a) * Brightness;
+        return;
+    }
+    
     vec3 vVec = normalize(Eye);
-    vec4 base = texture2D(Texture, Wrap);
-    vec3 bump = normalize(2.0 * texture2D(TextureNrm, Wrap).xyz - 1.0);
+    vec3 bump = normalize(2.0 * texture2D(TextureNrm, uv).xyz - 1.0);
     
     vec4 fragcolor = vec4(0.0, 0.0, 0.0, 0.0);
     
@@ -67,6 +79,9 @@ void main(void)
         );
     }
     
+    fragcolor.rgb += MaterialAmbient *
+        texture2D(LightMap, LightMapCoord).rgb * base.rgb;
+    
     gl_FragColor = fragcolor * Brightness;
 }
 
@@ -21,6 +21,8 @@ varying float Depth;
 /*varying vec3 LightDir;*/
 
 uniform sampler2D Texture;
+uniform sampler2D LightMap; // baked item lights
+varying vec2 LightMapCoord;
 /*uniform vec3 LightAmbient;*/
 /*uniform vec3 LightDiffuse;*/
 /*uniform vec3 LightSpecular;*/
@@ -45,7 +47,10 @@ bool floatcmp(float a, float b, float e)
 
 void main()
 {
-    vec4 color = texture2D(Texture, Wrap);
+    // unlit tiles (parallax chunks) come with u shifted by 2
+    bool unlit = Wrap.x > 1.5;
+    vec2 uv = unlit ? vec2(Wrap.x - 2.0, Wrap.y) : Wrap;
+    vec4 color = texture2D(Texture, uv);
     float e = 0.1; // threshold
     if(floatcmp(color.r, 1.0, e) &&
         floatcmp(color.g, 0.0, e) &&
@@ -58,6 +63,11 @@ void main()
         discard;
     }
     
+    if(unlit) {
+        gl_FragColor = vec4(color.rgb * MaterialEmissive, color.a) * Brightness;
+        return;
+    }
+    
     vec3 n = normalize(Normal);
     vec4 fragcolor = vec4(0.0, 0.0, 0.0, 0.0);
     vec3 v = normalize(vec3(-Position));
@@ -76,6 +86,8 @@ void main()
             MaterialDiffuse.a
         );
     }
+    fragcolor.rgb += MaterialAmbient *
+        texture2D(LightMap, LightMapCoord).rgb * color.rgb;
     
     /*gl_FragColor = fragcolor;*/
     gl_FragColor = mix(fragcolor, vec4(FogColor.rgb,1.0), FogColor.a * Depth) * Brightness;
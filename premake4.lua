@@ -143,6 +143,7 @@ solution("microarmy")
         files {
             "src/**.h",
             "src/**.cpp",
+            "test/**.cpp",
             "lib/Qor/Qor/**.h",
             "lib/Qor/Qor/**.cpp",
             "lib/Qor/lib/kit/**.h",
@@ -186,3 +187,32 @@ solution("microarmy")
             "`pkg-config --libs cairomm-1.0 pangomm-1.4`"
         }
 
+
+    project "mapc"
+        kind "ConsoleApp"
+        language "C++"
+        links {
+            "jsoncpp",
+            "boost_system",
+            "boost_thread",
+        }
+
+        -- Project Files
+        files {
+            "tools/mapc/**.cpp",
+            "src/MapFile.h",
+            "src/MapFile.cpp",
+            "lib/Qor/lib/kit/kit/log/**.h",
+            "lib/Qor/lib/kit/kit/log/**.cpp"
+        }
+
+        includedirs {
+            "lib/Qor/lib/kit",
+            "/usr/local/include/",
+            "/usr/include/jsoncpp"
+        }
+
+        libdirs {
+            "/usr/local/lib",
+            "/usr/local/lib64/",
+        }
@@ -0,0 +1,147 @@
+#include "BulletPool.h"
+#include <algorithm>
+
+using namespace std;
+using namespace glm;
+
+// where idle bullets wait, far from anything the partitioner tests them against
+static const vec3 PARKED(-1000000.0f, -1000000.0f, 0.0f);
+
+
+Bullet :: Bullet(
+    std::shared_ptr<MeshGeometry> geometry,
+    std::vector<std::shared_ptr<IMeshModifier>> mods,
+    std::shared_ptr<MeshMaterial> material
+):
+    Mesh(geometry, mods, material)
+{}
+
+
+BulletPool :: BulletPool(
+    Cache<Resource, std::string>* resources,
+    BasicPartitioner* partitioner,
+    unsigned type,
+    unsigned size
+):
+    m_pResources(resources),
+    m_pPartitioner(partitioner),
+    m_Type(type),
+    m_pGeometry(make_shared<MeshGeometry>(Prefab::quad(glm::vec2(8.0f, 2.0f)))),
+    m_pWrap(make_shared<Wrap>(Prefab::quad_wrap(
+        glm::vec2(0.0f, 1.0f), glm::vec2(1.0f, 0.0f)
+    ))),
+    m_pMaterials{
+        make_shared<MeshMaterial>("laser.png", resources),
+        make_shared<MeshMaterial>("laser.png", resources)
+    }
+{
+    // only player shots glow, as they did before pooling
+    m_pMaterials[PLAYER]->emissive(Color::white());
+
+    m_Bullets.reserve(size);
+    m_Active.reserve(size);
+    for (unsigned o = 0; o < OWNERS; ++o) {
+        m_Free[o].reserve(size / OWNERS);
+        for (unsigned i = 0; i < size / OWNERS; ++i)
+            m_Free[o].push_back(allocate((Owner)o));
+    }
+}
+
+
+Bullet* BulletPool :: allocate(Owner owner) {
+    auto b = make_shared<Bullet>(
+        m_pGeometry,
+        vector<shared_ptr<IMeshModifier>>{ m_pWrap },
+        m_pMaterials[owner]
+    );
+    b->m_Owner = owner;
+    
+    // increase box Z width
+    auto box = b->box();
+    b->set_box(Box(
+        vec3(box.min().x, box.min().y, -5.0),
+        vec3(box.max().x, box.max().y, 5.0)
+    ));
+    park(b.get());
+
+    m_pPartitioner->register_object(b, m_Type);
+    m_Bullets.push_back(b);
+    return b.get();
+}
+
+
+void BulletPool :: park(Bullet* b) {
+    b->visible(false);
+    b->velocity(vec3(0.0f));
+    b->position(PARKED);
+}
+
+
+Bullet* BulletPool :: spawn(Owner owner, float life, Node* parent) {
+    Bullet* b;
+    auto& free = m_Free[owner];
+    if (free.empty()) {
+        b = allocate(owner);
+    } else {
+        b = free.back();
+        free.pop_back();
+    }
+
+    b->m_pPlayer = nullptr;
+    b->m_pMonster = nullptr;
+    b->m_Life = life;
+    b->m_bActive = true;
+    b->reset_orientation();
+    b->position(vec3(0.0f));
+    b->velocity(vec3(0.0f));
+    b->visible(true);
+    if (parent)
+        parent->add(b->as_node());
+
+    m_Active.push_back(b);
+    return b;
+}
+
+
+void BulletPool :: release(Node* node) {
+    auto b = (Bullet*)node;
+    if (not b->m_bActive)
+        return;
+
+    b->m_bActive = false;
+    park(b);
+    if (b->parent())
+        b->safe_detach();
+
+    m_Active.erase(std::find(ENTIRE(m_Active), b));
+    m_Released.push_back(b);
+}
+
+
+void BulletPool :: logic(Freq::Time t) {
+    // bullets released last frame are free once their detach went through
+    auto itr = std::remove_if(ENTIRE(m_Released), [this](Bullet* b){
+        if (b->parent())
+            return false;
+        m_Free[b->m_Owner].push_back(b);
+        return true;
+    });
+    m_Released.erase(itr, m_Released.end());
+
+    for (unsigned i = 0; i < m_Active.size();) {
+        auto b = m_Active[i];
+        b->m_Life -= t.s();
+        if (b->m_Life > 0.0f) {
+            ++i;
+            continue;
+        }
+
+        // not inside a collision callback here, detach right away
+        b->m_bActive = false;
+        park(b);
+        b->detach();
+        m_Active[i] = m_Active.back();
+        m_Active.pop_back();
+        m_Free[b->m_Owner].push_back(b);
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef BULLETPOOL_H_J6MZ0C1E
+#define BULLETPOOL_H_J6MZ0C1E
+
+#include <memory>
+#include <vector>
+#include "Qor/Mesh.h"
+#include "Qor/BasicPartitioner.h"
+
+class Player;
+class Monster;
+
+class Bullet: public Mesh {
+    public:
+        Bullet(
+            std::shared_ptr<MeshGeometry> geometry,
+            std::vector<std::shared_ptr<IMeshModifier>> mods,
+            std::shared_ptr<MeshMaterial> material
+        );
+        virtual ~Bullet() {}
+
+        bool active() const { return m_bActive; }
+        Player* player() const { return m_pPlayer; }
+        Monster* monster() const { return m_pMonster; }
+        int damage() const { return m_Damage; }
+
+        void owner(Player* p) { m_pPlayer = p; }
+        void owner(Monster* m) { m_pMonster = m; }
+
+    private:
+        friend class BulletPool;
+
+        Player* m_pPlayer = nullptr;
+        Monster* m_pMonster = nullptr;
+        int m_Damage = 1;
+        float m_Life = 0.0f;
+        unsigned m_Owner = 0;
+        bool m_bActive = false;
+};
+
+// Preallocated bullets sharing one geometry buffer, with one material per
+// owner kind.  Bullets stay registered with the partitioner for the lifetime
+// of the pool and are recycled on expiry or hit instead of being destroyed.
+// Idle bullets are parked far outside the map, so no query reaches them.
+class BulletPool {
+    public:
+        enum Owner {
+            PLAYER, // emissive shots
+            MONSTER,
+            OWNERS
+        };
+
+        static const unsigned DEFAULT_SIZE = 64;
+
+        BulletPool(
+            Cache<Resource, std::string>* resources,
+            BasicPartitioner* partitioner,
+            unsigned type,
+            unsigned size = DEFAULT_SIZE
+        );
+        ~BulletPool() {}
+
+        // takes a free bullet that expires after life seconds,
+        // attached to parent if given
+        Bullet* spawn(Owner owner, float life, Node* parent = nullptr);
+
+        // safe to call from collision callbacks
+        void release(Node* bullet);
+
+        void logic(Freq::Time t);
+
+        unsigned active() const { return m_Active.size(); }
+        const std::vector<Bullet*>& bullets() const { return m_Active; }
+        unsigned size() const { return m_Bullets.size(); }
+
+    private:
+        Bullet* allocate(Owner owner);
+        void park(Bullet* b);
+
+        Cache<Resource, std::string>* m_pResources = nullptr;
+        BasicPartitioner* m_pPartitioner = nullptr;
+        unsigned m_Type = 0;
+
+        std::shared_ptr<MeshGeometry> m_pGeometry;
+        std::shared_ptr<IMeshModifier> m_pWrap;
+        std::shared_ptr<MeshMaterial> m_pMaterials[OWNERS];
+
+        std::vector<std::shared_ptr<Bullet>> m_Bullets; // owns everything
+        std::vector<Bullet*> m_Free[OWNERS];
+        std::vector<Bullet*> m_Active;
+        std::vector<Bullet*> m_Released; // waiting for their detach
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef COLLIDERS_H_5NDQ0VZB
+#define COLLIDERS_H_5NDQ0VZB
+
+#include "Qor/Node.h"
+
+// Typed handles to the mask nodes an entity registers with the partitioner,
+// so gameplay code never has to look them up by name.  They don't own
+// anything: a mask is the entity itself or one of its children.
+struct Colliders {
+    Node* body = nullptr;
+    Node* feet = nullptr; // optional
+    Node* sides = nullptr; // optional
+};
+
+#endif
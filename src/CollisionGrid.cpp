@@ -0,0 +1,112 @@
+#include "CollisionGrid.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+using namespace glm;
+
+
+CollisionGrid :: CollisionGrid(TileLayer* layer, glm::vec2 tile_size):
+    m_pLayer(layer),
+    m_TileSize(tile_size)
+{
+    // index 0 is always the full cell
+    m_MaskTable.push_back(Box(vec3(0.0f), vec3(1.0f)));
+}
+
+
+glm::ivec2 CollisionGrid :: cell(const glm::vec3& world) const {
+    return ivec2(
+        (int)std::floor(world.x / m_TileSize.x),
+        (int)std::floor(world.y / m_TileSize.y)
+    );
+}
+
+
+void CollisionGrid :: add(MapTile* tile, const Box& world_box, unsigned flags) {
+    m_Pending.push_back(Entry{tile, cell(world_box.center()), flags | OCCUPIED, 0});
+}
+
+
+void CollisionGrid :: add(MapTile* tile, const Box& world_box, unsigned flags, const Box& world_mask) {
+    auto c = cell(world_box.center());
+    m_Pending.push_back(Entry{tile, c, flags | OCCUPIED, intern_mask(c, world_mask)});
+}
+
+
+unsigned CollisionGrid :: intern_mask(const glm::ivec2& c, const Box& world_mask) {
+    // store relative to the cell, in tile units, so equal masks share an entry
+    auto origin = vec2(c) * m_TileSize;
+    auto lo = (vec2(world_mask.min()) - origin) / m_TileSize;
+    auto hi = (vec2(world_mask.max()) - origin) / m_TileSize;
+    auto rel = Box(vec3(glm::min(lo, hi), 0.0f), vec3(glm::max(lo, hi), 1.0f));
+
+    for (unsigned i = 0; i < m_MaskTable.size(); ++i) {
+        auto&& m = m_MaskTable[i];
+        if (vec2(m.min()) == vec2(rel.min()) && vec2(m.max()) == vec2(rel.max()))
+            return i;
+    }
+
+    assert(m_MaskTable.size() < 0xFFFF);
+    m_MaskTable.push_back(rel);
+    return m_MaskTable.size() - 1;
+}
+
+
+void CollisionGrid :: bake() {
+    if (m_Pending.empty())
+        return;
+
+    ivec2 lo = m_Pending[0].cell;
+    ivec2 hi = lo;
+    for (auto&& e: m_Pending) {
+        lo = glm::min(lo, e.cell);
+        hi = glm::max(hi, e.cell);
+    }
+
+    m_Min = lo;
+    m_Size = hi - lo + ivec2(1);
+
+    size_t n = m_Size.x * m_Size.y;
+    m_Flags.assign(n, 0);
+    m_Masks.assign(n, 0);
+    m_Tiles.assign(n, nullptr);
+
+    for (auto&& e: m_Pending) {
+        int i = index(e.cell.x, e.cell.y);
+        m_Flags[i] |= e.flags;
+        if (e.mask || not m_Tiles[i])
+            m_Masks[i] = e.mask;
+        if (e.flags & ~OCCUPIED || not m_Tiles[i])
+            m_Tiles[i] = e.tile;
+    }
+
+    m_Pending.clear();
+    m_Pending.shrink_to_fit();
+}
+
+
+CollisionGrid::Cell CollisionGrid :: make_cell(int x, int y, int i, float zmin, float zmax) const {
+    auto origin = vec2(x, y) * m_TileSize;
+    auto&& rel = m_MaskTable[m_Masks[i]];
+    return Cell{
+        m_Tiles[i],
+        m_Flags[i],
+        origin,
+        Box(
+            vec3(origin + vec2(rel.min()) * m_TileSize, zmin),
+            vec3(origin + vec2(rel.max()) * m_TileSize, zmax)
+        )
+    };
+}
+
+
+std::vector<std::weak_ptr<Node>> CollisionGrid :: provide(const Box& box, unsigned flags) const {
+    vector<weak_ptr<Node>> r;
+    each(box, flags, [&r](const Cell& c){
+        if (c.tile)
+            r.push_back(c.tile->as_node());
+    });
+    return r;
+}
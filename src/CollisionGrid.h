@@ -0,0 +1,109 @@
+#ifndef COLLISIONGRID_H_8WJ2PXQD
+#define COLLISIONGRID_H_8WJ2PXQD
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Qor/TileMap.h"
+
+// Dense per-layer lookup of tile collision data, built once at load.
+// Each cell holds a flag byte and an index into a small table of distinct
+// mask sub-boxes (in tile units), so queries are direct cell indexing
+// instead of walking layer nodes and their config.
+class CollisionGrid {
+    public:
+        enum Flag {
+            OCCUPIED = 1 << 0,
+            STATIC = 1 << 1,
+            LEDGE = 1 << 2,
+            FATAL = 1 << 3,
+
+            SOLID = STATIC | LEDGE
+        };
+
+        struct Cell {
+            MapTile* tile;
+            unsigned flags;
+            glm::vec2 origin; // world position of the cell's top left
+            Box mask; // world space, z spans the query
+        };
+
+        CollisionGrid(TileLayer* layer, glm::vec2 tile_size);
+        ~CollisionGrid() {}
+
+        // build phase, world_box is the tile's world box
+        void add(MapTile* tile, const Box& world_box, unsigned flags = OCCUPIED);
+        void add(MapTile* tile, const Box& world_box, unsigned flags, const Box& world_mask);
+        void bake();
+
+        TileLayer* layer() const { return m_pLayer; }
+        glm::vec2 tile_size() const { return m_TileSize; }
+        glm::ivec2 cell(const glm::vec3& world) const;
+
+        unsigned flags(int x, int y) const {
+            int i = index(x, y);
+            return i >= 0 ? m_Flags[i] : 0;
+        }
+        bool occupied(int x, int y) const { return flags(x, y) & OCCUPIED; }
+        MapTile* tile(int x, int y) const {
+            int i = index(x, y);
+            return i >= 0 ? m_Tiles[i] : nullptr;
+        }
+
+        // calls func(const Cell&) for every cell matching any of flags whose
+        // mask overlaps the world space box
+        template<class Func>
+        void each(const Box& box, unsigned flags, Func func) const {
+            auto lo = cell(box.min());
+            auto hi = cell(box.max());
+            lo = glm::max(lo, m_Min);
+            hi = glm::min(hi, m_Min + m_Size - glm::ivec2(1));
+            for (int y = lo.y; y <= hi.y; ++y) {
+                int row = (y - m_Min.y) * m_Size.x - m_Min.x;
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    unsigned f = m_Flags[row + x];
+                    if (not (f & flags))
+                        continue;
+                    Cell c = make_cell(x, y, row + x, box.min().z, box.max().z);
+                    if (c.mask.collision(box))
+                        func(c);
+                }
+            }
+        }
+
+        // partitioner provider backend for one of the collision flags
+        std::vector<std::weak_ptr<Node>> provide(const Box& box, unsigned flags) const;
+
+    private:
+        struct Entry {
+            MapTile* tile;
+            glm::ivec2 cell;
+            unsigned flags;
+            unsigned mask;
+        };
+
+        int index(int x, int y) const {
+            x -= m_Min.x;
+            y -= m_Min.y;
+            if (x < 0 || y < 0 || x >= m_Size.x || y >= m_Size.y)
+                return -1;
+            return y * m_Size.x + x;
+        }
+        Cell make_cell(int x, int y, int i, float zmin, float zmax) const;
+        unsigned intern_mask(const glm::ivec2& c, const Box& world_mask);
+
+        TileLayer* m_pLayer = nullptr;
+        glm::vec2 m_TileSize;
+        glm::ivec2 m_Min = glm::ivec2(0);
+        glm::ivec2 m_Size = glm::ivec2(0);
+
+        std::vector<uint8_t> m_Flags;
+        std::vector<uint16_t> m_Masks; // 0 is the full cell
+        std::vector<MapTile*> m_Tiles;
+        std::vector<Box> m_MaskTable; // tile units, relative to cell
+
+        std::vector<Entry> m_Pending;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "EntityRegistry.h"
+#include <fstream>
+#include <json/json.h>
+#include "kit/log/log.h"
+
+using namespace std;
+
+const uint32_t EntityRegistry :: FLIP_BITS;
+
+
+EntityRegistry :: EntityRegistry():
+    m_Types({ Type{"", NONE, 0} }),
+    m_Variants({ "" })
+{
+    add("spawn", SPAWN);
+    add("altspawn", ALTSPAWN);
+}
+
+
+unsigned EntityRegistry :: add(const std::string& name, Kind kind, unsigned id) {
+    auto itr = m_Names.find(name);
+    if (itr != m_Names.end()) {
+        m_Types[itr->second] = Type{name, kind, id};
+        return itr->second;
+    }
+
+    unsigned idx = m_Types.size();
+    m_Types.push_back(Type{name, kind, id});
+    m_Names[name] = idx;
+    return idx;
+}
+
+
+void EntityRegistry :: load(const std::string& fn) {
+    ifstream f(fn);
+    if (not f)
+        ERRORf(READ, "entities %s", fn);
+
+    Json::Value root;
+    Json::Reader reader;
+    if (not reader.parse(f, root) || not root.isObject())
+        ERRORf(PARSE, "entities %s", fn);
+
+    for (auto&& name: root.getMemberNames()) {
+        auto& e = root[name];
+        auto base = find(e.get("as", "").asString());
+        if (base) {
+            add(name, m_Types[base].kind, m_Types[base].id);
+            continue;
+        }
+
+        auto kind = e.get("kind", "").asString();
+        if (kind == "thing")
+            add(name, THING, e.get("id", 0).asUInt());
+        else if (kind == "monster")
+            add(name, MONSTER, e.get("id", 0).asUInt());
+        else if (kind == "spawn")
+            add(name, SPAWN);
+        else if (kind == "altspawn")
+            add(name, ALTSPAWN);
+        else
+            WARNING("entity " + name + " in " + fn + " has no known kind");
+    }
+}
+
+
+unsigned EntityRegistry :: find(const std::string& name) const {
+    if (name.empty())
+        return 0;
+    auto itr = m_Names.find(name);
+    return itr == m_Names.end() ? 0 : itr->second;
+}
+
+
+unsigned EntityRegistry :: find(const std::shared_ptr<Meta>& config) const {
+    return find(config->at<string>("name", ""));
+}
+
+
+void EntityRegistry :: bind(uint32_t gid, const std::string& name, const std::string& variant) {
+    gid &= ~FLIP_BITS;
+    if (gid >= m_Tiles.size())
+        m_Tiles.resize(gid + 1);
+
+    auto& t = m_Tiles[gid];
+    t.type = find(name);
+    t.variant = 0;
+    if (variant.empty())
+        return;
+
+    for (unsigned i = 1; i < m_Variants.size(); ++i)
+        if (m_Variants[i] == variant) {
+            t.variant = i;
+            return;
+        }
+    t.variant = m_Variants.size();
+    m_Variants.push_back(variant);
+}
+
+
+void EntityRegistry :: clear_tiles() {
+    m_Tiles.clear();
+}
+
+
+const std::string& EntityRegistry :: variant(uint32_t gid) const {
+    gid &= ~FLIP_BITS;
+    return gid < m_Tiles.size() ? m_Variants[m_Tiles[gid].variant] : m_Variants[0];
+}
@@ -0,0 +1,73 @@
+#ifndef ENTITYREGISTRY_H_6TQZ2MWC
+#define ENTITYREGISTRY_H_6TQZ2MWC
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Qor/Node.h"
+
+// Maps entity names, and once a map is loaded its tileset gids, to a small
+// table of type descriptors, so classifying a tile is an array index.
+// Built in types are added by the game, others can come from data:
+//   { "coin": { "kind": "thing", "as": "battery" } }
+class EntityRegistry {
+    public:
+        enum Kind {
+            NONE = 0,
+            SPAWN,
+            ALTSPAWN,
+            MONSTER,
+            THING
+        };
+
+        // tiled stores tile orientation in the top bits of a gid
+        static const uint32_t FLIP_BITS = 0xe0000000;
+
+        struct Type {
+            std::string name;
+            Kind kind;
+            unsigned id; // Monster::Type or Thing::Type
+        };
+
+        EntityRegistry();
+        ~EntityRegistry() {}
+
+        // returns the type index, an existing name is replaced
+        unsigned add(const std::string& name, Kind kind, unsigned id = 0);
+        // data types, "as" reuses the behavior of an existing name
+        void load(const std::string& fn);
+
+        // 0 (the NONE type) if unknown
+        unsigned find(const std::string& name) const;
+        unsigned find(const std::shared_ptr<Meta>& config) const;
+        const Type& type(unsigned idx) const { return m_Types[idx]; }
+        const Type& type(const std::shared_ptr<Meta>& config) const {
+            return m_Types[find(config)];
+        }
+        const Type& operator[](unsigned idx) const { return m_Types[idx]; }
+        size_t size() const { return m_Types.size(); }
+
+        // per map, from the precompiled spawn records
+        void bind(uint32_t gid, const std::string& name, const std::string& variant = "");
+        void clear_tiles();
+        unsigned tile(uint32_t gid) const {
+            gid &= ~FLIP_BITS;
+            return gid < m_Tiles.size() ? m_Tiles[gid].type : 0;
+        }
+        const std::string& variant(uint32_t gid) const;
+
+    private:
+        struct Tile {
+            unsigned type = 0;
+            unsigned variant = 0;
+        };
+
+        std::vector<Type> m_Types;
+        std::unordered_map<std::string, unsigned> m_Names;
+        std::vector<Tile> m_Tiles; // indexed by gid
+        std::vector<std::string> m_Variants; // 0 is ""
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "FireChain.h"
+#include <limits>
+
+using namespace std;
+using namespace glm;
+
+
+FireChain :: FireChain(
+    Cache<Resource, std::string>* resources,
+    BasicPartitioner* partitioner,
+    unsigned type,
+    Node* owner
+):
+    m_pPartitioner(partitioner),
+    m_pOwner(owner),
+    m_pCollider(make_shared<Node>()),
+    m_pFlames(make_shared<ParticleSystem>(
+        "fire.png", resources, 3, vec2(0.0f), RING, FPS
+    ))
+{
+    m_Ring.resize(RING);
+    add(m_pFlames);
+
+    add(m_pCollider);
+    update_collider();
+    m_pPartitioner->register_object(m_pCollider, type);
+}
+
+
+void FireChain :: start(glm::vec3 offset, float dir, int length) {
+    m_Offset = offset;
+    m_Dir = dir;
+    m_Remaining = length;
+    m_SpreadTimer = 0.0f;
+    spread();
+}
+
+
+void FireChain :: stop() {
+    m_Remaining = 0;
+    m_Count = 0;
+    m_pFlames->clear();
+    update_collider();
+}
+
+
+void FireChain :: spread() {
+    // full ring, the oldest flame stops burning early
+    if (m_Count == RING) {
+        m_First = (m_First + 1) % RING;
+        --m_Count;
+    }
+
+    auto& s = m_Ring[(m_First + m_Count) % RING];
+    ++m_Count;
+
+    m_Offset.x += m_Dir * SIZE;
+    s.age = 0.0f;
+    s.pos = m_pOwner->position() + m_Offset;
+    m_pFlames->emit(s.pos, vec2(0.0f), BURN, SIZE);
+
+    if (on_spread)
+        on_spread(position(Space::WORLD) + s.pos);
+}
+
+
+void FireChain :: logic_self(Freq::Time t) {
+    if (not m_Count && not m_Remaining)
+        return;
+
+    float dt = t.s();
+    for (unsigned i = 0; i < m_Count; ++i)
+        m_Ring[(m_First + i) % RING].age += dt;
+
+    // flames go out oldest first
+    while (m_Count && m_Ring[m_First].age >= BURN) {
+        m_First = (m_First + 1) % RING;
+        --m_Count;
+    }
+
+    if (m_Remaining > 0) {
+        m_SpreadTimer += dt;
+        while (m_Remaining > 0 && m_SpreadTimer >= SPREAD) {
+            m_SpreadTimer -= SPREAD;
+            --m_Remaining;
+            spread();
+        }
+    }
+
+    update_collider();
+}
+
+
+void FireChain :: update_collider() {
+    // out of every query while nothing burns
+    if (not m_Count) {
+        m_pCollider->box() = Box(vec3(-1000000.0f), vec3(-1000000.0f));
+        m_pCollider->visible(false);
+        return;
+    }
+
+    vec3 half(SIZE * 0.5f, SIZE * 0.5f, 0.0f);
+    vec3 lo(numeric_limits<float>::max());
+    vec3 hi(-numeric_limits<float>::max());
+    for (unsigned i = 0; i < m_Count; ++i) {
+        auto p = m_Ring[(m_First + i) % RING].pos;
+        lo = glm::min(lo, p - half);
+        hi = glm::max(hi, p + half);
+    }
+
+    m_pCollider->box() = Box(vec3(lo.x, lo.y, -5.0f), vec3(hi.x, hi.y, 5.0f));
+    m_pCollider->visible(true);
+}
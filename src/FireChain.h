@@ -0,0 +1,74 @@
+#ifndef FIRECHAIN_H_T2WQ7GBU
+#define FIRECHAIN_H_T2WQ7GBU
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Qor/BasicPartitioner.h"
+#include "ParticleSystem.h"
+
+// A wizard's trail of flames.  Segments live in a fixed ring and are
+// advanced together in one update, and drawn as particles of one emitter;
+// one collider spanning the burning segments is registered with the
+// partitioner instead of one per flame.
+// Each flame starts next to where the owner stands when it spreads, then
+// stays put, so the chain goes in the owner's parent and not under the
+// owner itself.
+class FireChain: public Node {
+    public:
+        // a new flame every SPREAD seconds, each burning for BURN seconds
+        static constexpr float SPREAD = 0.05f;
+        static constexpr float BURN = 0.5f;
+        static const unsigned RING = 12; // > BURN / SPREAD
+        static constexpr float SIZE = 8.0f; // one fire.png frame
+        static constexpr float FPS = 10.0f;
+
+        FireChain(
+            Cache<Resource, std::string>* resources,
+            BasicPartitioner* partitioner,
+            unsigned type,
+            Node* owner // a sibling of the chain
+        );
+        virtual ~FireChain() {}
+
+        virtual void logic_self(Freq::Time t) override;
+
+        // spreads length more flames after the first from offset to the
+        // owner, one flame width further in dir each time, restarting any
+        // chain still spreading
+        void start(glm::vec3 offset, float dir, int length);
+
+        // puts every flame out and stops spreading
+        void stop();
+
+        // called with the world position of each new flame
+        std::function<void(glm::vec3)> on_spread;
+
+        bool burning() const { return m_Count > 0; }
+        unsigned count() const { return m_Count; }
+        const std::shared_ptr<Node>& collider() const { return m_pCollider; }
+
+    private:
+        struct Segment {
+            glm::vec3 pos;
+            float age = 0.0f;
+        };
+
+        void spread();
+        void update_collider();
+
+        BasicPartitioner* m_pPartitioner = nullptr;
+        Node* m_pOwner = nullptr;
+        std::shared_ptr<Node> m_pCollider;
+        std::shared_ptr<ParticleSystem> m_pFlames;
+        std::vector<Segment> m_Ring;
+        unsigned m_First = 0; // oldest burning segment
+        unsigned m_Count = 0;
+
+        glm::vec3 m_Offset;
+        float m_Dir = 1.0f;
+        int m_Remaining = 0;
+        float m_SpreadTimer = 0.0f;
+};
+
+#endif
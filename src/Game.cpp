@@ -2,18 +2,34 @@
 #include "Thing.h"
 #include "Monster.h"
 #include "Player.h"
+#include "ProviderRegistry.h"
+#include "CollisionGrid.h"
+#include "TileBatcher.h"
+#include "MapFile.h"
+#include "BulletPool.h"
+#include "ParticleSystem.h"
 #include "Qor/BasicPartitioner.h"
 #include "Qor/Input.h"
 #include "Qor/Qor.h"
 #include "Qor/Shader.h"
 #include <glm/glm.hpp>
+#include <boost/filesystem.hpp>
 #include <cstdlib>
 #include <chrono>
+#include <map>
 #include <thread>
 
 using namespace std;
 using namespace glm;
 
+static_assert(
+    (unsigned)MapFile::OCCUPIED == (unsigned)CollisionGrid::OCCUPIED &&
+    (unsigned)MapFile::STATIC == (unsigned)CollisionGrid::STATIC &&
+    (unsigned)MapFile::LEDGE == (unsigned)CollisionGrid::LEDGE &&
+    (unsigned)MapFile::FATAL == (unsigned)CollisionGrid::FATAL,
+    "map file flags must match the collision grid"
+);
+
 
 namespace _ = std::placeholders;
 
@@ -24,8 +40,13 @@ Game :: Game(Qor* engine):
     m_pRoot(make_shared<Node>()),
     m_pPipeline(engine->pipeline()),
     m_pPartitioner(engine->pipeline()->partitioner()),
+    m_Providers(engine->pipeline()->partitioner()),
     m_pController(engine->session()->active_profile(0)->controller()),
-    m_pTimeline(engine->timer()->timeline())
+    m_pTimeline(&m_FixedTimeline),
+    m_PlayerHash(ACTIVATION_CELL_SIZE),
+    m_MonsterHash(ACTIVATION_CELL_SIZE),
+    m_ThingHash(ACTIVATION_CELL_SIZE),
+    m_bHeadless(engine->args().has("--headless"))
     //m_JumpTimer(engine->timer()->timeline()),
     //m_ShootTimer(engine->timer()->timeline())
 {}
@@ -56,12 +77,78 @@ void Game :: preload() {
     
     m_pMap = m_pQor->make<TileMap>(lev + ".tmx");
     m_pRoot->add(m_pMap);
+
+    // whatever Pregame already loaded in the background
+    auto preloaded = LevelPreloader::get().take(lev);
+    if (preloaded) {
+        m_pMapFile = preloaded->map_file;
+        for (auto&& def: preloaded->sprites)
+            m_SpriteDefs.add(def);
+    }
+
+    // collision flags precompiled by mapc
+    if (not m_pMapFile) {
+        auto fn = map_file(m_pQor, lev);
+        if (not fn.empty()) {
+            try {
+                m_pMapFile = make_shared<MapFile>(fn);
+            } catch(...) {
+                // e.g. written by an older mapc, tile properties still work
+                WARNING("Ignoring unreadable precompiled map " + fn);
+            }
+        }
+    }
+    
+    // entity types: built in, then from data, then this map's gids
+    for (unsigned i = 1; i < Monster::type_names().size(); ++i)
+        m_Entities.add(Monster::type_names()[i], EntityRegistry::MONSTER, i);
+    for (unsigned i = 1; i < Thing::type_names().size(); ++i)
+        m_Entities.add(Thing::type_names()[i], EntityRegistry::THING, i);
+    auto entities_fn = m_pQor->resource_path("entities.json");
+    if (boost::filesystem::exists(entities_fn))
+        m_Entities.load(entities_fn);
+    if (m_pMapFile)
+        for (uint32_t i = 0; i < m_pMapFile->spawns(); ++i) {
+            auto& s = m_pMapFile->spawn(i);
+            m_Entities.bind(s.gid, m_pMapFile->str(s.name), m_pMapFile->str(s.type));
+        }
     
     m_pMusic = m_pQor->make<Sound>(lev + ".ogg");
     m_pRoot->add(m_pMusic);
+
+    // effects go through a fixed set of voices instead of Sound nodes
+    if (not m_bHeadless) {
+        m_pMixer = kit::make_unique<Mixer>(m_pResources);
+        auto audio = m_pResources->config()->meta("audio");
+        m_pMixer->gain(
+            audio->at<int>("volume", 100) / 100.0f *
+            audio->at<int>("sound-volume", 100) / 100.0f
+        );
+        m_Sounds.die = m_pMixer->sample("die.wav", 1, 3);
+        m_Sounds.jump = m_pMixer->sample("jump.wav", 1, 2, Mixer::DROP);
+        m_Sounds.touch = m_pMixer->sample("touch.wav", 1, 1, Mixer::DROP);
+        m_Sounds.shoot = m_pMixer->sample("shoot.wav", 4, 1);
+        m_Sounds.hit = m_pMixer->sample("hit.wav", 4, 0);
+        m_Sounds.damage = m_pMixer->sample("damage.wav", 2, 1);
+        m_Sounds.pickup = m_pMixer->sample("pickup.wav", 2, 2);
+        m_Sounds.pickup2 = m_pMixer->sample("pickup2.wav", 2, 2);
+        m_Sounds.spring = m_pMixer->sample("spring.wav", 1, 1, Mixer::DROP);
+        m_Sounds.fire = m_pMixer->sample("fire.wav", 2, 0);
+    }
     
     auto scale = 250.0f / std::max<float>(sw* 1.0f, 1.0f);
     m_pCamera->rescale(glm::vec3(scale, scale, 1.0f));
+    m_Visibility.camera(m_pCamera.get(), vec2(sw, sh) * scale, vec3(scale, scale, 1.0f));
+
+    // things and monsters this far outside the view and every player sleep
+    m_ViewSize = vec2(sw, sh) * scale;
+    m_WakeMargin = boost::lexical_cast<float>(m_pQor->args().value_or(
+        "wake_margin", boost::lexical_cast<string>(DEFAULT_WAKE_MARGIN)
+    ));
+    auto _this = this;
+    m_pCamera->on_move.connect([_this]{
+        _this->m_bViewMoved = true;
+    });
 
     m_pChar = make_shared<Player>(
         m_pQor->resource_path("guy.json"),
@@ -73,6 +160,35 @@ void Game :: preload() {
         this
     );
     //m_pChar->texture()->ambient(Color::red(1.0f)*0.5f);
+
+    auto input = m_pQor->args().value_or("input", "");
+    if (not input.empty()) {
+        m_pScript = kit::make_unique<InputScript>(input);
+        m_pChar->input(m_pScript.get());
+    }
+    m_RecordPath = m_pQor->args().value_or("record", "");
+
+    auto hz = std::max(boost::lexical_cast<unsigned>(
+        m_pQor->args().value_or("hz", boost::lexical_cast<string>(DEFAULT_HZ))
+    ), 1u);
+    m_StepMS = std::max<unsigned>((1000 + hz / 2) / hz, 1);
+
+    m_TracePath = m_pQor->args().value_or("trace", "");
+    m_bProfileOverlay = m_pQor->args().has("--profile") && not m_bHeadless;
+    if (m_bProfileOverlay || not m_TracePath.empty()) {
+        m_pProfiler = kit::make_unique<Profiler>(not m_bHeadless);
+        m_pProfiler->capture(not m_TracePath.empty());
+    }
+
+    if (m_bHeadless) {
+        m_TickLimit = boost::lexical_cast<unsigned>(m_pQor->args().value_or(
+            "ticks",
+            m_pScript ? boost::lexical_cast<string>(m_pScript->length() + 1) : "3600"
+        ));
+        std::srand(boost::lexical_cast<unsigned>(
+            m_pQor->args().value_or("seed", "0")
+        ));
+    }
     m_pRoot->add(m_pChar);
     
     m_Players.push_back(m_pChar);
@@ -100,25 +216,49 @@ void Game :: preload() {
     ));
     m_pCamera->add(m_pViewLight);
 
+    m_pBullets = make_shared<BulletPool>(m_pResources, m_pPartitioner, BULLET);
+
+    // effects, in world space
+    m_pGibs = make_shared<ParticleSystem>("blood.png", m_pResources, 4, vec2(0.0f, 500.0f));
+    m_pEmbers = make_shared<ParticleSystem>("fire.png", m_pResources, 3, vec2(0.0f, -60.0f));
+    m_pSparkles = make_shared<ParticleSystem>("particle.png", m_pResources);
+    m_pRoot->add(m_pGibs);
+    m_pRoot->add(m_pEmbers);
+    m_pRoot->add(m_pSparkles);
+
     m_Stars = { 0, 0, 0 };
     m_MaxStars = { 0, 0, 0 };
     
+    auto tile_size = vec2(m_pMap->tile_size().x, m_pMap->tile_size().y);
+    m_Visibility.tile_size(tile_size);
+    bool batch = not m_pQor->args().has("--no-batch");
+
     vector<vector<shared_ptr<TileLayer>>*> layer_types {
         &m_pMap->layers(),
         &m_pMap->object_layers()
     };
 
+    unsigned layer_index = 0;
     for(auto&& layers: layer_types) {
         for(auto&& layer: *layers) {
-            layer->set_main_camera(m_pCamera.get());
-            layer->bake_visible();
+            // mapc only writes tile layers, in tmx order
+            const uint8_t* cells = nullptr;
+            const uint32_t* gids = nullptr;
+            if (m_pMapFile &&
+                layers == &m_pMap->layers() &&
+                m_pMapFile->layers() == m_pMap->layers().size()
+            ) {
+                cells = m_pMapFile->cells(layer_index);
+                gids = m_pMapFile->tiles(layer_index);
+            }
+            if (layers == &m_pMap->layers())
+                ++layer_index;
 
-            auto camera = m_pCamera.get();
-            m_pCamera->on_move.connect([layer, camera]{
-                layer->bake_visible();
-            });
+            layer->set_main_camera(m_pCamera.get());
+            bool parallax_layer = layer->config()->has("parallax");
+            m_Visibility.add(layer, parallax_layer);
             
-            if (layer->config()->has("parallax")) {
+            if (parallax_layer) {
                 float parallax = boost::lexical_cast<float>(
                     layer->config()->at<string>("parallax", "1.0")
                 );
@@ -128,20 +268,46 @@ void Game :: preload() {
                 auto pl = ParallaxLayer();
 
                 pl.root = layer;
+                pl.origin = layer->position();
                 pl.scale = parallax;
 
                 m_ParallaxLayers.push_back(pl);
-                auto l = make_shared<Light>();
-                l->ambient(color);
-                l->diffuse(color);
-                l->specular(color);
-                l->dist(10000.0f);
-                pl.root->add(l);
-                pl.light = l;
+
+                // background only, every tile can be merged.  Always
+                // batched, the chunks are baked unlit and carry the
+                // layer's color as their emissive tint, since the layer is
+                // drawn in the same pass and under the same lights as the
+                // rest
+                TileBatcher batcher(tile_size, CHUNK_TILES);
+                for (auto&& tile_ptr: layer->all_descendants()) {
+                    auto obj = tile_ptr ?
+                        std::dynamic_pointer_cast<MapTile>(tile_ptr->as_node()) :
+                        shared_ptr<MapTile>();
+                    if (obj)
+                        batcher.add(obj.get());
+                }
+                if (batcher.tiles()) {
+                    auto chunks = make_shared<Node>();
+                    chunks->name("chunks");
+                    map<MeshMaterial*, shared_ptr<MeshMaterial>> tinted;
+                    batcher.bake(chunks.get(), [&tinted, color](const shared_ptr<MeshMaterial>& m){
+                        auto& t = tinted[m.get()];
+                        if (not t) {
+                            t = make_shared<MeshMaterial>(*m);
+                            t->emissive(color);
+                        }
+                        return t;
+                    }, true);
+                    layer->add(chunks);
+                }
 
                 continue;
             }
             
+            bool layer_has_depth = false;
+            auto grid = make_shared<CollisionGrid>(layer.get(), tile_size);
+            TileBatcher batcher(tile_size, CHUNK_TILES);
+
             for (auto&& tile_ptr: layer->all_descendants()) {
                 if (not tile_ptr)
                     continue;
@@ -153,44 +319,56 @@ void Game :: preload() {
                 if(obj) {
                     auto obj_cfg = obj->config();
                     obj->box() = obj->mesh()->box();
-                    auto name = obj_cfg->at<string>("name", "");
+                    grid->add(obj.get(), obj->world_box());
+
+                    // precompiled cell, or -1 to fall back to tile config
+                    int ci = -1;
+                    auto c = grid->cell(obj->world_box().center());
+                    if (cells &&
+                        c.x >= 0 && c.x < (int)m_pMapFile->width() &&
+                        c.y >= 0 && c.y < (int)m_pMapFile->height()
+                    )
+                        ci = c.y * m_pMapFile->width() + c.x;
+
+                    auto& entity = ci >= 0 ?
+                        m_Entities[m_Entities.tile(gids[ci])] :
+                        m_Entities.type(obj_cfg);
+                    string variant;
+                    if (entity.kind != EntityRegistry::NONE) {
+                        variant = ci >= 0 ?
+                            m_Entities.variant(gids[ci]) :
+                            obj_cfg->at<string>("type", "");
+                        m_Tags.add(entity.name, variant, obj.get());
+                    }
 
-                    if(name=="spawn") {
+                    if (entity.kind == EntityRegistry::SPAWN ||
+                        entity.kind == EntityRegistry::ALTSPAWN
+                    ) {
                         obj->visible(false);
                         obj->mesh()->visible(false);
-                        m_Spawns.push_back(obj.get());
                         
                         continue;
 
-                    } else if (name=="altspawn") {
-                        obj->visible(false);
-                        obj->mesh()->visible(false);
-                        m_AltSpawns.push_back(obj.get());
-
-                        continue;
-
-                    } else if (Monster::get_type(obj_cfg)) {
+                    } else if (entity.kind == EntityRegistry::MONSTER) {
                         auto monster = make_shared<Monster>(
                             obj_cfg,
                             obj.get(),
                             this,
                             m_pMap.get(),
                             m_pPartitioner,
-                            m_pQor->timer()->timeline(),
+                            m_pTimeline,
                             m_pQor->resources()
                         );
                         obj->add(monster);
                         setup_monster(monster);
                         continue;
-                    } else if (Thing::get_id(obj_cfg)) {
-                        if (name == "star") {
-                            auto typ = obj_cfg->at<string>("type");
-
-                            if (typ == "bronze")
+                    } else if (entity.kind == EntityRegistry::THING) {
+                        if (entity.id == Thing::STAR) {
+                            if (variant == "bronze")
                                 ++m_MaxStars[0];
-                            else if (typ == "silver")
+                            else if (variant == "silver")
                                 ++m_MaxStars[1];
-                            else if (typ == "gold")
+                            else if (variant == "gold")
                                 ++m_MaxStars[2];
                         }
                         
@@ -200,7 +378,7 @@ void Game :: preload() {
                             this,
                             m_pMap.get(),
                             m_pPartitioner,
-                            m_pQor->timer()->timeline(),
+                            m_pTimeline,
                             m_pQor->resources()
                         );
                         obj->add(thing);
@@ -209,30 +387,25 @@ void Game :: preload() {
                         continue;
                     }
 
-                    bool depth = layer->depth() || obj->config()->has("depth");
-
-                    if (depth) {
-
-                        // make a provider function that queries the map layer
-                        // for currently visible objects identifiable by a string
-                        // in their config
-                        auto provider_for = [layer](string s){
-                            return [s,layer](Box box){
-                                vector<std::weak_ptr<Node>> r;
-                                auto nodes = layer->query(box, [s](Node* n){
-                                    return n->config()->has(s);
-                                });
-                                std::transform(ENTIRE(nodes), back_inserter(r), [](Node* n){
-                                    return std::weak_ptr<Node>(n->as_node());
-                                });
-
-                                return r;
-                            };
-                        };
-                        m_pPartitioner->register_provider(STATIC, provider_for("static"));
-                        m_pPartitioner->register_provider(LEDGE, provider_for("ledge"));
-                        m_pPartitioner->register_provider(FATAL, provider_for("fatal"));
-                        
+                    if (batch)
+                        batcher.add(obj.get());
+
+                    unsigned flags = 0;
+                    if (ci >= 0) {
+                        flags = cells[ci] &
+                            (CollisionGrid::STATIC | CollisionGrid::LEDGE | CollisionGrid::FATAL);
+                    } else if (layer->depth() || obj_cfg->has("depth")) {
+                        if (obj_cfg->has("fatal"))
+                            flags = CollisionGrid::FATAL;
+                        else if (obj_cfg->has("ledge"))
+                            flags = CollisionGrid::LEDGE;
+                        else
+                            flags = CollisionGrid::STATIC;
+                    }
+
+                    if (flags) {
+                        layer_has_depth = true;
+
                         auto n = make_shared<Node>();
                         n->name("mask");
                         auto mask = obj_cfg->at<shared_ptr<Meta>>("mask", shared_ptr<Meta>());
@@ -262,24 +435,41 @@ void Game :: preload() {
                         }
 
                         obj->mesh()->add(n);
-
-                        if (obj_cfg->has("fatal")) {
-                            obj_cfg->set<string>("fatal", "");
-                        }
-
-                        else if (obj_cfg->has("ledge"))
-                            obj_cfg->set<string>("ledge", "");
-                        else {
-                            obj_cfg->set<string>("static", "");
-                        }
+                        grid->add(obj.get(), obj->world_box(), flags, n->world_box());
                     }
                 }
             }
+
+            grid->bake();
+            m_CollisionGrids.push_back(grid);
+
+            if (batcher.tiles()) {
+                auto chunks = make_shared<Node>();
+                chunks->name("chunks");
+                batcher.bake(chunks.get());
+                layer->add(chunks);
+            }
+
+            if (layer_has_depth) {
+                // one provider per layer and type, answered by the layer's grid
+                auto provider_for = [grid](unsigned flags){
+                    return [grid, flags](Box box){
+                        return grid->provide(box, flags);
+                    };
+                };
+                m_Providers.add(layer.get(), STATIC, provider_for(CollisionGrid::STATIC));
+                m_Providers.add(layer.get(), LEDGE, provider_for(CollisionGrid::LEDGE));
+                m_Providers.add(layer.get(), FATAL, provider_for(CollisionGrid::FATAL));
+            }
         }
     }
 
     m_pHUD->set(m_StarLevel, m_Stars[0], m_MaxStars[0]);
 
+    // every item has added its light by now
+    m_LightMap.fit(tile_size);
+    m_LightMap.bake();
+
     for (auto&& player: m_Players) {
         auto _this = this;
 
@@ -384,7 +574,7 @@ void Game :: preload() {
         MONSTER, STATIC, std::bind(&Monster::cb_to_static, _::_1, _::_2)
     );
     m_pPartitioner->on_collision(
-        MONSTER, FATAL, std::bind(&Monster::cb_to_static, _::_1, _::_2)
+        MONSTER, FATAL, std::bind(&Monster::cb_to_fatal, _::_1, _::_2)
     );
     m_pPartitioner->on_collision(
         MONSTER, BULLET, std::bind(&Monster::cb_to_bullet, _::_1, _::_2)
@@ -409,7 +599,7 @@ void Game :: preload() {
 
 void Game :: reset() {
     try {
-        m_pChar->position(m_Spawns.at(0)->position());
+        m_pChar->position(m_Tags.find("spawn").at(0)->position());
     } catch(...) {
         WARNING("Map has no spawn points");
     }
@@ -421,6 +611,12 @@ void Game :: reset() {
 
 
 Game :: ~Game() {
+    if (not m_RecordPath.empty())
+        m_Recording.save(m_RecordPath);
+    if (m_pProfiler && not m_TracePath.empty()) {
+        LOGf("trace: %s events over %s frames", m_pProfiler->events() % m_pProfiler->frames());
+        m_pProfiler->write_trace(m_TracePath);
+    }
     m_pPipeline->partitioner()->clear();
 }
 
@@ -429,6 +625,14 @@ void Game :: setup_thing(std::shared_ptr<Thing> thing) {
     thing->initialize();
     m_Things.push_back(thing);
 
+    // objects like doors and springs have no per-tick work, leave them be,
+    // items sleep until a player comes near, see update_activation()
+    if (thing->is_item()) {
+        thing->cell() = m_ThingHash.cell(vec2(thing->position(Space::WORLD)));
+        m_ThingHash.insert(thing.get(), thing->cell());
+        thing->sleep();
+    }
+
     for(auto&& player: m_Players)
         setup_player_to_thing(player,thing);
 }
@@ -437,6 +641,11 @@ void Game :: setup_monster(std::shared_ptr<Monster> monster) {
     monster->initialize();
     m_Monsters.push_back(monster);
 
+    // asleep until a player comes near, see update_activation()
+    monster->cell() = m_MonsterHash.cell(vec2(monster->position(Space::WORLD)));
+    m_MonsterHash.insert(monster.get(), monster->cell());
+    monster->sleep();
+
     for(auto&& player: m_Players)
         setup_player_to_monster(player,monster);
 }
@@ -444,6 +653,8 @@ void Game :: setup_monster(std::shared_ptr<Monster> monster) {
 
 void Game :: setup_player(std::shared_ptr<Player> player) {
 
+    Colliders colliders;
+
     // create masks
     auto n = make_shared<Node>();
     n->name("mask");
@@ -455,6 +666,7 @@ void Game :: setup_player(std::shared_ptr<Player> player) {
     player->add(n);
     n->config()->set<Player*>("player", player.get());
     m_pPartitioner->register_object(n, CHARACTER);
+    colliders.body = n.get();
 
     // create masks
     n = make_shared<Node>();
@@ -466,6 +678,7 @@ void Game :: setup_player(std::shared_ptr<Player> player) {
 
     player->add(n);
     m_pPartitioner->register_object(n, CHARACTER_FEET);
+    colliders.feet = n.get();
 
     n = make_shared<Node>();
     n->name("sidemask");
@@ -476,6 +689,9 @@ void Game :: setup_player(std::shared_ptr<Player> player) {
 
     player->add(n);
     m_pPartitioner->register_object(n, CHARACTER_SIDES);
+    colliders.sides = n.get();
+
+    player->colliders(colliders);
 
     //setup_player_to_map(player);
 
@@ -550,8 +766,8 @@ void Game :: setup_player_to_thing(std::shared_ptr<Player> player, std::shared_p
 void Game :: setup_player_to_monster(std::shared_ptr<Player> player, std::shared_ptr<Monster> monster) {}
 
 std::vector<Node*> Game :: get_static_collisions(Node* a) {
-    auto static_cols = m_pPartitioner->get_collisions_for(a, STATIC);
-    auto ledge_cols = m_pPartitioner->get_collisions_for(a, LEDGE);
+    PROFILE_ZONE("static collisions");
+    std::vector<Node*> r;
     
     auto m = a->parent();
     vec3 old_pos;
@@ -560,81 +776,169 @@ std::vector<Node*> Game :: get_static_collisions(Node* a) {
     else
         old_pos = m->position(Space::WORLD);
     
-    std::copy_if(ENTIRE(ledge_cols), std::back_inserter(static_cols), [old_pos,a](Node* n){
-        return old_pos.y <= n->position(Space::WORLD).y;
+    // ledges only count when we were above them
+    auto box = a->world_box();
+    for (auto&& grid: m_CollisionGrids) {
+        grid->each(box, CollisionGrid::SOLID, [&r, old_pos](const CollisionGrid::Cell& c){
+            if ((c.flags & CollisionGrid::STATIC) || old_pos.y <= c.origin.y)
+                r.push_back(c.tile);
+        });
+    }
+
+    return r;
+}
+
+
+CollisionGrid* Game :: collision_grid(TileLayer* layer) {
+    for (auto&& grid: m_CollisionGrids)
+        if (grid->layer() == layer)
+            return grid.get();
+    return nullptr;
+}
+
+
+Player* Game :: closest_player(glm::vec3 pos, float radius, float* dist) {
+    Player* closest = nullptr;
+    float min_dist = radius;
+
+    m_PlayerHash.each_near(vec2(pos), radius, [&closest, &min_dist, pos](Player* player){
+        auto d = glm::length(player->position(Space::WORLD) - pos);
+        if (d < min_dist) {
+            min_dist = d;
+            closest = player;
+        }
     });
 
-    return static_cols;
+    if (dist)
+        *dist = min_dist;
+    return closest;
 }
 
 
-void Game :: cb_to_static(Node* a, Node* b, Node* m) {
-    if (not m)
-        m = a;
-    
-    auto p = m->position(Space::PARENT);
-    auto v = m->velocity();
-    auto col = [this, a, b]() -> bool {
-        return (not get_static_collisions(a).empty()) ||
-            a->world_box().collision(b->world_box());
-    };
+void Game :: monster_moved(Monster* monster) {
+    m_MonsterHash.update(monster, monster->cell(), vec2(monster->position(Space::WORLD)));
+}
 
-    //Box overlap = a->world_box().intersect(b->world_box());
-    vec3 old_pos;
-    try {
-        old_pos = Matrix::translation(kit::safe_ptr(m->snapshot(0))->world_transform);
-    } catch(...) {
-        return;
+
+void Game :: remove_monster(Monster* monster) {
+    m_MonsterHash.remove(monster, monster->cell());
+
+    auto itr = std::find(ENTIRE(m_AwakeMonsters), monster);
+    if (itr != m_AwakeMonsters.end())
+        m_AwakeMonsters.erase(itr);
+    monster->sleep();
+}
+
+
+// wakes everything in hash inside the rect, once per activation frame
+template<class T>
+static void wake_in(
+    SpatialHash<T*>& hash, vector<T*>& awake,
+    vec2 lo, vec2 hi, unsigned frame
+){
+    hash.each_in(lo, hi, [&awake, frame](T* e){
+        if (e->wake_frame() == frame)
+            return;
+        e->wake_frame(frame);
+
+        if (not e->awake()) {
+            e->wake();
+            awake.push_back(e);
+        }
+    });
+}
+
+
+// anything nothing came near this frame goes back to sleep
+template<class T>
+static void sleep_rest(vector<T*>& awake, unsigned frame) {
+    for (unsigned i = 0; i < awake.size();) {
+        auto e = awake[i];
+        if (e->wake_frame() == frame) {
+            ++i;
+            continue;
+        }
+
+        e->sleep();
+        awake[i] = awake.back();
+        awake.pop_back();
     }
+}
 
-    auto np = vec3(p.x, old_pos.y, p.z);
-    m->position(np);
 
-    if(not col()){
-        m->velocity(glm::vec3(v.x, 0.0f, v.z));
-        return;
+void Game :: update_activation() {
+    ++m_ActivationFrame;
+
+    // wake monsters and items in the cells around the view, which only
+    // changes when the camera moves
+    if (m_bViewMoved) {
+        m_bViewMoved = false;
+        auto pos = vec2(m_pCamera->position(Space::WORLD));
+        m_ViewMin = pos - vec2(m_WakeMargin);
+        m_ViewMax = pos + m_ViewSize + vec2(m_WakeMargin);
+    }
+    wake_in(m_MonsterHash, m_AwakeMonsters, m_ViewMin, m_ViewMax, m_ActivationFrame);
+    wake_in(m_ThingHash, m_AwakeThings, m_ViewMin, m_ViewMax, m_ActivationFrame);
+
+    // and around each player, who may be off screen
+    m_PlayerHash.clear();
+    auto margin = vec2(m_WakeMargin);
+    for (auto&& player: m_Players) {
+        auto pos = vec2(player->position(Space::WORLD));
+        m_PlayerHash.insert(player.get(), m_PlayerHash.cell(pos));
+
+        wake_in(m_MonsterHash, m_AwakeMonsters, pos - margin, pos + margin, m_ActivationFrame);
+        wake_in(m_ThingHash, m_AwakeThings, pos - margin, pos + margin, m_ActivationFrame);
     }
 
-    np = vec3(old_pos.x, p.y, p.z);
-    m->position(np);
+    sleep_rest(m_AwakeMonsters, m_ActivationFrame);
+    sleep_rest(m_AwakeThings, m_ActivationFrame);
+}
+
 
-    if(not col())
+void Game :: cb_to_static(Node* a, Node* b) {
+    PROFILE_ZONE("cb_to_static");
+    auto player = a->config()->at<Player*>("player", nullptr);
+    if (not player)
         return;
 
-    m->position(vec3(old_pos.x, old_pos.y, p.z));
-    m->velocity(glm::vec3(0.0f));
+    // solid things (closed doors) are not in the grids, the body is
+    // resolved against their box as well
+    auto thing = dynamic_cast<Thing*>(b);
+    player->body().resolve(thing && thing->solid() ? b : nullptr);
 }
 
 
 void Game :: cb_to_ledge(Node* a, Node* b) {
-    auto m = a->parent();
-    auto old_pos = Matrix::translation(kit::safe_ptr(m->snapshot(0))->world_transform);
-
-    if (m->velocity().y >= K_EPSILON and old_pos.y <= b->position(Space::WORLD).y)
-        cb_to_static(a, b, a->parent());
+    // the body only lands on ledges from above
+    cb_to_static(a, b);
 }
 
 
 void Game :: cb_to_tile(Node* a, Node* b) {
-    cb_to_static(a, b, a->parent());
+    cb_to_static(a, b);
 }
 
 
 void Game :: cb_to_fatal(Node* a, Node* b) {
-    Sound::play(m_pCamera.get(), "die.wav", m_pResources);
+    sound(m_Sounds.die, m_pCamera.get());
     reset();
     m_pChar->velocity(glm::vec3(0.0f));
 }
 
 
 void Game :: cb_bullet_to_static(Node* a, Node* b) {
-    Sound::play(a, "hit.wav", m_pResources);
-    a->safe_detach();
+    if (not ((Bullet*)a)->active())
+        return;
+
+    sound(m_Sounds.hit, a);
+    m_pBullets->release(a);
 }
 
 
 void Game :: enter() {
-    m_pMusic->play();
+    if (not m_bHeadless)
+        m_pMusic->play();
     
     if(m_pQor->args().has("--low"))
         m_Shader = m_pPipeline->load_shaders({"lit"});
@@ -661,37 +965,249 @@ void Game :: enter() {
 
     for (auto&& player: m_Players)
         player->enter();
+
+    m_HeadlessStart = chrono::steady_clock::now();
+}
+
+
+std::string Game :: map_file(Qor* engine, const std::string& lev) {
+    namespace fs = boost::filesystem;
+    auto tmx = engine->resource_path(lev + ".tmx");
+    auto bin = fs::path(tmx).replace_extension(".map");
+    if (fs::exists(bin) && fs::last_write_time(bin) >= fs::last_write_time(tmx))
+        return bin.string();
+    return string();
+}
+
+
+LevelPreloader::Request Game :: preload_request(Qor* engine, const std::string& lev) {
+    LevelPreloader::Request req;
+    req.name = lev;
+    req.map_file = map_file(engine, lev);
+    for (auto&& name: Monster::type_names())
+        if (not name.empty())
+            req.sprites.push_back(engine->resources()->transform(name + ".json"));
+    req.files.push_back(engine->resource_path(lev + ".tmx"));
+    req.files.push_back(engine->resource_path(lev + ".ogg"));
+    return req;
+}
+
+
+std::shared_ptr<const SpriteDef> Game :: sprite_def(const std::string& fn) {
+    return m_SpriteDefs.get(fn);
+}
+
+
+unsigned Game :: add_light(glm::vec3 pos, glm::vec3 color, float dist) {
+    return m_LightMap.add(pos, color, dist);
+}
+
+
+void Game :: enable_light(unsigned id, bool on) {
+    m_LightMap.enable(id, on);
+}
+
+
+void Game :: after(float delay, const Timer& timer) {
+    m_Timers.add(delay, timer);
+}
+
+
+void Game :: expire(Timer& timer) {
+    auto node = timer.node.lock();
+    if (not node)
+        return;
+
+    switch (timer.action) {
+        case Timer::COLLECT: {
+            auto thing = dynamic_pointer_cast<Thing>(node);
+            if (thing)
+                thing->collected();
+            break;
+        }
+    }
+}
+
+
+void Game :: sound(Mixer::Handle h, Node* at) {
+    if (m_pMixer)
+        m_pMixer->play(h, at->position(Space::WORLD));
 }
 
 
 void Game :: logic(Freq::Time t) {
+    if (m_pProfiler) {
+        m_pProfiler->frame();
+        m_ProfileOverlayTime += t.s();
+        if (m_bProfileOverlay && m_ProfileOverlayTime >= PROFILE_OVERLAY_INTERVAL) {
+            m_ProfileOverlayTime = 0.0f;
+            m_pHUD->overlay(m_pProfiler->overlay());
+        }
+    }
+    PROFILE_ZONE("logic");
+
+    auto step = Freq::Time::ms(m_StepMS);
+    if (not m_bHeadless) {
+        // whole steps of the time that passed, the rest carries over and
+        // render() blends the last two steps by it.  Long stalls are
+        // dropped instead of being caught up all at once
+        m_StepTime = std::min(m_StepTime + t.s(), MAX_STEPS_PER_FRAME * step.s());
+        while (m_StepTime >= step.s()) {
+            m_StepTime -= step.s();
+            snapshot_motion();
+            m_FixedTimeline.logic(step);
+            tick(step);
+        }
+        m_StepBlend = m_StepTime / step.s();
+        return;
+    }
+
+    // as many fixed steps as fit in the frame, regardless of wall time
+    auto frame = chrono::steady_clock::now();
+    while (m_Tick < m_TickLimit) {
+        m_FixedTimeline.logic(step);
+        tick(step);
+        if (chrono::steady_clock::now() - frame > chrono::milliseconds(HEADLESS_BUDGET_MS))
+            break;
+    }
+
+    if (m_Tick >= m_TickLimit) {
+        auto elapsed = chrono::duration<double>(
+            chrono::steady_clock::now() - m_HeadlessStart
+        ).count();
+        LOGf("headless: %s ticks in %ss (%s ticks/s, %sx real time)",
+            m_Tick % elapsed %
+            (m_Tick / std::max(elapsed, 0.001)) %
+            (m_Tick * m_StepMS / 1000.0 / std::max(elapsed, 0.001))
+        );
+        LOGf("sprite defs: %s loaded, %s hits, %s misses",
+            m_SpriteDefs.size() % m_SpriteDefs.hits() % m_SpriteDefs.misses()
+        );
+        m_pQor->quit();
+    }
+}
+
+
+void Game :: snapshot_motion() {
+    m_Motion.clear();
+    auto add = [this](const shared_ptr<Node>& n, float spin){
+        m_Motion.push_back(Motion{n, n->position(), n->position(), spin});
+    };
+    add(m_pCamera, 0.0f);
+    for (auto&& player: m_Players)
+        add(player, 0.0f);
+    for (auto&& monster: m_AwakeMonsters)
+        add(monster->as_node(), 0.0f);
+    for (auto&& bullet: m_pBullets->bullets())
+        add(bullet->as_node(), 0.0f);
+    // thrown things, and the node a collected star spirals around
+    for (auto&& thing: m_AwakeThings) {
+        if (glm::length(thing->velocity()) > K_EPSILON)
+            add(thing->as_node(), 0.0f);
+        if (thing->spinning())
+            add(thing->parent()->as_node(), m_StepMS / 1000.0f);
+    }
+}
+
+
+void Game :: blend_motion(bool on) const {
+    for (auto&& m: m_Motion) {
+        auto n = m.node.lock();
+        if (not n)
+            continue;
+        if (on) {
+            m.current = n->position();
+            // teleports and respawns snap
+            if (glm::length(m.current - m.previous) < BLEND_MAX_DIST)
+                n->position(m.previous + (m.current - m.previous) * m_StepBlend);
+            if (m.spin > 0.0f)
+                n->rotate(-m.spin * (1.0f - m_StepBlend), glm::vec3(0.0f, 0.0f, 1.0f));
+        } else {
+            n->position(m.current);
+            if (m.spin > 0.0f)
+                n->rotate(m.spin * (1.0f - m_StepBlend), glm::vec3(0.0f, 0.0f, 1.0f));
+        }
+    }
+    // particles take back the rest of their last step themselves
+    if (on) {
+        m_pGibs->blend(m_StepBlend);
+        m_pEmbers->blend(m_StepBlend);
+        m_pSparkles->blend(m_StepBlend);
+    }
+}
+
+
+void Game :: tick(Freq::Time t) {
+    PROFILE_ZONE("tick");
+
+    if (m_pScript)
+        m_pScript->tick(m_Tick);
+    if (not m_RecordPath.empty())
+        m_Recording.record(m_Tick, m_pController.get());
+    ++m_Tick;
+
     Actuation::logic(t);
+
+    m_ProviderCalls = m_Providers.calls();
+    m_Providers.reset_calls();
     
     if (m_pInput->key(SDLK_ESCAPE))
         m_pQor->quit();
 
-    m_pRoot->logic(t);
+    {
+        PROFILE_ZONE("activation");
+        update_activation();
+    }
+    auto _this = this;
+    m_Timers.advance(t.s(), [_this](Timer& timer){
+        _this->expire(timer);
+    });
+    m_pBullets->logic(t);
+    {
+        PROFILE_ZONE("root logic");
+        m_pRoot->logic(t);
+    }
     m_pOrthoRoot->logic(t);
 }
 
 void Game :: render() const {
+    if (m_bHeadless)
+        return;
+    PROFILE_ZONE("render");
+
+    // nodes are drawn between the last two steps, then put back
+    blend_motion(true);
+
     m_pPipeline->override_shader(PassType::NORMAL, m_Shader);
+    m_pPipeline->shader(m_Shader)->use();
+    m_LightMap.apply();
 
-    unsigned idx = 0;
+    // a parallax layer follows the camera by (1 - scale) of its motion,
+    // which looks the same as viewing it from pos * scale, so every layer
+    // is drawn from the main camera in one pass, in map order
     auto pos = m_pCamera->position();
-
-    for (auto&& layer: m_ParallaxLayers) {
-        layer.root->visible(true);
-        m_pCamera->position(pos.x * layer.scale, pos.y * layer.scale, 5.0f);
-        m_pPipeline->render(layer.root.get(), m_pCamera.get(), nullptr, Pipeline::LIGHTS | (idx==0?0:Pipeline::NO_CLEAR));
-        layer.root->visible(false);
-        ++idx;
+    {
+        PROFILE_ZONE("visibility");
+        for (auto&& layer: m_ParallaxLayers) {
+            auto ofs = vec2(pos) * (1.0f - layer.scale);
+            layer.root->position(layer.origin + vec3(ofs, 0.0f));
+            m_Visibility.update(
+                layer.root.get(),
+                vec3(pos.x * layer.scale, pos.y * layer.scale, pos.z)
+            );
+        }
+        m_Visibility.update(pos);
     }
 
-    m_pCamera->position(pos);
-    m_pPipeline->render(m_pRoot.get(), m_pCamera.get(), nullptr, Pipeline::LIGHTS | (idx==0?0:Pipeline::NO_CLEAR));
+    {
+        PROFILE_PASS("main pass");
+        m_pPipeline->render(m_pRoot.get(), m_pCamera.get(), nullptr, Pipeline::LIGHTS);
+    }
     m_pPipeline->override_shader(PassType::NORMAL, (unsigned)PassType::NONE);
     
     m_pPipeline->winding(true);
+    PROFILE_PASS("hud pass");
     m_pPipeline->render(m_pOrthoRoot.get(), m_pOrthoCamera.get(), nullptr, Pipeline::NO_CLEAR | Pipeline::NO_DEPTH);
+
+    blend_motion(false);
 }
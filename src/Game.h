@@ -1,6 +1,7 @@
 #ifndef _PREGAMESTATE_H
 #define _PREGAMESTATE_H
 
+#include <chrono>
 #include "Qor/Node.h"
 #include "Qor/State.h"
 #include "Qor/Input.h"
@@ -11,11 +12,27 @@
 #include "Qor/Sound.h"
 #include "Qor/Sprite.h"
 #include "HUD.h"
+#include "ProviderRegistry.h"
+#include "SpatialHash.h"
+#include "VisibilityBaker.h"
+#include "InputScript.h"
+#include "LevelPreloader.h"
+#include "SpriteDef.h"
+#include "EntityRegistry.h"
+#include "TagIndex.h"
+#include "TimerWheel.h"
+#include "Mixer.h"
+#include "LightMap.h"
+#include "Profiler.h"
 
 class Qor;
 class Thing;
 class Monster;
 class Player;
+class CollisionGrid;
+class BulletPool;
+class ParticleSystem;
+class MapFile;
 
 class Game: public State {
     public:
@@ -44,7 +61,7 @@ class Game: public State {
 
         void reset();
         
-        void cb_to_static(Node* a, Node* b, Node* m);
+        void cb_to_static(Node* a, Node* b);
         void cb_to_ledge(Node* a, Node* b);
         void cb_to_tile(Node* a, Node* b);
         void cb_to_fatal(Node* a, Node* b);
@@ -58,10 +75,18 @@ class Game: public State {
         void setup_player_to_monster(std::shared_ptr<Player> player, std::shared_ptr<Monster> monster);
         //void setup_player_to_map(std::shared_ptr<Plyaer> player);
         std::vector<Node*> get_static_collisions(Node* a);
+        
+        CollisionGrid* collision_grid(TileLayer* layer);
+        const std::vector<std::shared_ptr<CollisionGrid>>& collision_grids() const {
+            return m_CollisionGrids;
+        }
+        
+        // provider calls made by the partitioner during the last frame
+        unsigned provider_calls() const { return m_ProviderCalls; }
 
         struct ParallaxLayer {
             std::shared_ptr<Node> root;
-            std::shared_ptr<Light> light;
+            glm::vec3 origin;
             float scale = 1.0f;
         };
         
@@ -70,27 +95,141 @@ class Game: public State {
         void shoot(Sprite* origin);
 
         std::vector<std::shared_ptr<Player>>& players() { return m_Players; }
+
+        // closest player within radius of pos, or nullptr
+        Player* closest_player(glm::vec3 pos, float radius, float* dist = nullptr);
+        void monster_moved(Monster* monster);
+        void remove_monster(Monster* monster);
+
+        // precompiled map for lev, empty if missing or older than the tmx
+        static std::string map_file(Qor* engine, const std::string& lev);
+        // what Pregame loads in the background for lev
+        static LevelPreloader::Request preload_request(Qor* engine, const std::string& lev);
+
+        // parsed sprite json, loaded once per file
+        std::shared_ptr<const SpriteDef> sprite_def(const std::string& fn);
+        const SpriteDefCache& sprite_defs() const { return m_SpriteDefs; }
+        // what each entity name (and tile gid of this map) spawns
+        const EntityRegistry& entities() const { return m_Entities; }
+        // entity placeholders by name and type, e.g. ("door", "red")
+        const TagIndex& tags() const { return m_Tags; }
+
+        // stationary light baked at load, in world space
+        unsigned add_light(glm::vec3 pos, glm::vec3 color, float dist);
+        void enable_light(unsigned id, bool on);
+
+        // expiry record for the timer wheel, node is not kept alive by it
+        struct Timer {
+            enum Action {
+                COLLECT // a picked up thing finishes its pickup
+            };
+
+            Action action;
+            std::weak_ptr<Node> node;
+        };
+        // runs timer's action delay seconds of game time from now
+        void after(float delay, const Timer& timer);
+        size_t timers() const { return m_Timers.size(); }
+
+        // effect samples, registered with the mixer at load
+        struct Sounds {
+            Mixer::Handle die = Mixer::NONE;
+            Mixer::Handle jump = Mixer::NONE;
+            Mixer::Handle touch = Mixer::NONE;
+            Mixer::Handle shoot = Mixer::NONE;
+            Mixer::Handle hit = Mixer::NONE;
+            Mixer::Handle damage = Mixer::NONE;
+            Mixer::Handle pickup = Mixer::NONE;
+            Mixer::Handle pickup2 = Mixer::NONE;
+            Mixer::Handle spring = Mixer::NONE;
+            Mixer::Handle fire = Mixer::NONE;
+        };
+        const Sounds& sounds() const { return m_Sounds; }
+        // plays a sample at at's world position, unless running headless
+        void sound(Mixer::Handle h, Node* at);
+        Mixer* mixer() { return m_pMixer.get(); }
+        bool headless() const { return m_bHeadless; }
+
+        BulletPool* bullets() { return m_pBullets.get(); }
+        ParticleSystem* gibs() { return m_pGibs.get(); }
+        ParticleSystem* embers() { return m_pEmbers.get(); }
+        ParticleSystem* sparkles() { return m_pSparkles.get(); }
         
     private:
+        // one simulation step
+        void tick(Freq::Time t);
+        void update_activation();
+        void expire(Timer& timer);
+        // positions before a step, for blending in render()
+        void snapshot_motion();
+        void blend_motion(bool on) const;
+
+        // wake_margin=<units> default.  Monsters further than this from
+        // the view and every player only patrol, items there skip
+        // logic_self
+        static constexpr float DEFAULT_WAKE_MARGIN = 192.0f;
+        static constexpr float ACTIVATION_CELL_SIZE = 128.0f;
+        // timer wheel granularity, in seconds
+        static constexpr float TIMER_RESOLUTION = 0.01f;
+        // static tiles are merged into chunks this many tiles wide
+        static constexpr unsigned CHUNK_TILES = 16;
+        // seconds between profiler overlay refreshes
+        static constexpr float PROFILE_OVERLAY_INTERVAL = 0.5f;
+        // game logic runs in fixed steps, hz=<rate> per second of game
+        // time, rounded to whole milliseconds
+        static constexpr unsigned DEFAULT_HZ = 125;
+        // a slow frame runs at most this many steps, the rest is dropped
+        static constexpr float MAX_STEPS_PER_FRAME = 8.0f;
+        // blended moves longer than this are teleports and snap instead
+        static constexpr float BLEND_MAX_DIST = 64.0f;
+        // --headless spends at most this much wall time per frame stepping
+        static constexpr unsigned HEADLESS_BUDGET_MS = 100;
+
         Qor* m_pQor = nullptr;
         Cache<Resource, std::string>* m_pResources = nullptr;
         Input* m_pInput = nullptr;
         Pipeline* m_pPipeline = nullptr;
         BasicPartitioner* m_pPartitioner = nullptr;
+        ProviderRegistry m_Providers;
+        unsigned m_ProviderCalls = 0;
 
         std::shared_ptr<Node> m_pRoot;
         std::shared_ptr<Node> m_pOrthoRoot;
         std::shared_ptr<Camera> m_pOrthoCamera;
         std::shared_ptr<Camera> m_pCamera;
         std::shared_ptr<TileMap> m_pMap;
+        std::shared_ptr<MapFile> m_pMapFile;
+        SpriteDefCache m_SpriteDefs;
+        EntityRegistry m_Entities;
+        TagIndex m_Tags;
+        TimerWheel<Timer> m_Timers{TIMER_RESOLUTION};
         std::shared_ptr<Controller> m_pController;
         Freq::Timeline* m_pTimeline;
+        // drives m_pTimeline, so alarms only see fixed steps
+        Freq::Timeline m_FixedTimeline;
+        unsigned m_StepMS = 1000 / DEFAULT_HZ;
+        float m_StepTime = 0.0f; // game time not stepped yet
+        float m_StepBlend = 0.0f; // of a step, between the last two
+
+        struct Motion {
+            std::weak_ptr<Node> node;
+            glm::vec3 previous;
+            glm::vec3 current;
+            float spin; // turned by this much around z each step
+        };
+        mutable std::vector<Motion> m_Motion;
         std::shared_ptr<Player> m_pChar;
         std::shared_ptr<Light> m_pViewLight;
         std::shared_ptr<Sound> m_pMusic;
-        std::vector<MapTile*> m_Spawns;
-        std::vector<MapTile*> m_AltSpawns;
+        std::unique_ptr<Mixer> m_pMixer; // null when headless
+        Sounds m_Sounds;
         std::shared_ptr<HUD> m_pHUD;
+        std::shared_ptr<BulletPool> m_pBullets;
+        std::shared_ptr<ParticleSystem> m_pGibs;
+        std::shared_ptr<ParticleSystem> m_pEmbers;
+        std::shared_ptr<ParticleSystem> m_pSparkles; // pickups
+
+        std::vector<std::shared_ptr<CollisionGrid>> m_CollisionGrids;
 
         std::vector<std::shared_ptr<Thing>> m_Things;
         std::vector<std::shared_ptr<Monster>> m_Monsters;
@@ -111,7 +250,40 @@ class Game: public State {
         unsigned m_Shader = 0;
 
         std::vector<std::shared_ptr<Player>> m_Players;
+
+        SpatialHash<Player*> m_PlayerHash;
+        SpatialHash<Monster*> m_MonsterHash;
+        std::vector<Monster*> m_AwakeMonsters;
+        SpatialHash<Thing*> m_ThingHash;
+        std::vector<Thing*> m_AwakeThings;
+        unsigned m_ActivationFrame = 0;
+        float m_WakeMargin = DEFAULT_WAKE_MARGIN;
+        glm::vec2 m_ViewSize; // what the main camera sees, in world units
+        glm::vec2 m_ViewMin, m_ViewMax; // plus the margin, see on_move
+        bool m_bViewMoved = true;
+
+        // rebaked from render(), where the camera sits at each layer's offset
+        mutable VisibilityBaker m_Visibility;
+        mutable LightMap m_LightMap;
         std::vector<ParallaxLayer> m_ParallaxLayers;
+
+        // --headless: no rendering or audio, fixed steps until m_TickLimit
+        bool m_bHeadless = false;
+        unsigned m_Tick = 0;
+        unsigned m_TickLimit = 0;
+        std::chrono::steady_clock::time_point m_HeadlessStart;
+
+        // input=<file> replays a script, record=<file> saves one on exit
+        std::unique_ptr<InputScript> m_pScript;
+        InputScript m_Recording;
+        std::string m_RecordPath;
+
+        // --profile shows zone times on the HUD, trace=<file> saves a
+        // Chrome trace on exit
+        std::unique_ptr<Profiler> m_pProfiler;
+        std::string m_TracePath;
+        bool m_bProfileOverlay = false;
+        float m_ProfileOverlayTime = 0.0f;
 };
 
 #endif
@@ -0,0 +1,67 @@
+#include "GlyphText.h"
+
+using namespace std;
+using namespace glm;
+
+
+GlyphText :: GlyphText(
+    const std::string& fn,
+    const std::string& charset,
+    float size,
+    Cache<Resource, std::string>* resources
+):
+    m_Charset(charset),
+    m_Size(size)
+{
+    auto mat = make_shared<MeshMaterial>(fn, resources);
+    auto tex = mat->texture()->size();
+
+    m_Quad = Prefab::quad(vec2(size, size));
+    for (unsigned i = 0; i < m_Charset.size(); ++i)
+        m_GlyphWraps.push_back(Prefab::tile_wrap(
+            // square cells, as tall as the atlas
+            uvec2(tex.y, tex.y),
+            uvec2(tex.x, tex.y),
+            i
+        ));
+
+    m_pGeometry = make_shared<MeshGeometry>(vector<vec3>());
+    m_pWrap = make_shared<Wrap>(vector<vec2>());
+    m_pMesh = make_shared<Mesh>(
+        m_pGeometry,
+        vector<shared_ptr<IMeshModifier>>{ m_pWrap },
+        mat
+    );
+    m_pMesh->visible(false);
+    add(m_pMesh);
+}
+
+
+void GlyphText :: set(const std::string& text) {
+    if (text == m_Text)
+        return;
+    m_Text = text;
+
+    const unsigned nv = m_Quad.size();
+    auto& verts = m_pGeometry->verts();
+    auto& wrap = m_pWrap->data();
+    verts.clear();
+    wrap.clear();
+
+    for (unsigned i = 0; i < m_Text.size(); ++i) {
+        auto g = m_Charset.find(m_Text[i]);
+        if (g == string::npos)
+            continue;
+        vec3 ofs(i * m_Size, 0.0f, 0.0f);
+        for (unsigned j = 0; j < nv; ++j) {
+            verts.push_back(m_Quad[j] + ofs);
+            wrap.push_back(m_GlyphWraps[g][j]);
+        }
+    }
+
+    m_pMesh->visible(not verts.empty());
+    if (verts.empty())
+        return;
+    m_pMesh->set_box(Box(vec3(0.0f, 0.0f, -1.0f), vec3(width(), m_Size, 1.0f)));
+    m_pMesh->clear_cache();
+}
@@ -0,0 +1,43 @@
+#ifndef GLYPHTEXT_H_P5LD0R7W
+#define GLYPHTEXT_H_P5LD0R7W
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Qor/Mesh.h"
+
+// Short text drawn as quads from a one row glyph atlas, one mesh for the
+// whole string.  The quad and texture coordinates of every glyph are built
+// once, so changing the text only rewrites a few vertices and the atlas
+// texture is uploaded once, not rasterized per change.
+// Top left aligned at the node's origin, characters outside the charset
+// (e.g. spaces) only advance.
+class GlyphText: public Node {
+    public:
+        GlyphText(
+            const std::string& fn,
+            const std::string& charset, // atlas order, left to right
+            float size, // glyph height in pixels, glyphs are square cells
+            Cache<Resource, std::string>* resources
+        );
+        virtual ~GlyphText() {}
+
+        void set(const std::string& text);
+        const std::string& text() const { return m_Text; }
+        float width() const { return m_Text.size() * m_Size; }
+
+    private:
+        std::string m_Charset;
+        float m_Size;
+        std::string m_Text;
+
+        // a quad of each glyph in the charset
+        std::vector<glm::vec3> m_Quad;
+        std::vector<std::vector<glm::vec2>> m_GlyphWraps;
+
+        std::shared_ptr<MeshGeometry> m_pGeometry;
+        std::shared_ptr<Wrap> m_pWrap;
+        std::shared_ptr<Mesh> m_pMesh;
+};
+
+#endif
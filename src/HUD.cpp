@@ -1,4 +1,5 @@
 #include "Qor/Mesh.h"
+#include <algorithm>
 #include "HUD.h"
 
 using namespace std;
@@ -17,11 +18,40 @@ HUD :: HUD(Window* window, Input* input, Cache<Resource,std::string>* cache):
 
     m_pCanvas = make_shared<Canvas>(sw, sh);
     add(m_pCanvas);
+    m_FontDesc = Pango::FontDescription("Monospace " + to_string(std::max(sw / 160, 8)));
+
+    // star icon, set() only moves its texture coordinates
+    m_pStarMaterial = make_shared<MeshMaterial>("items.png", m_pCache);
+    m_pStarWrap = make_shared<Wrap>(star_wrap(0));
+    m_pMesh = make_shared<Mesh>(
+        make_shared<MeshGeometry>(Prefab::quad(vec2(sw / 24, sw / 24))),
+        vector<shared_ptr<IMeshModifier>>{ m_pStarWrap },
+        m_pStarMaterial
+    );
+    add(m_pMesh);
+
+    // two cells of the same size right of the star
+    float glyph = sw / 27;
+    m_pCounter = make_shared<GlyphText>("hudfont.png", "0123456789/", glyph, m_pCache);
+    m_pCounter->position(vec3(glyph * 2.0f, 0.0f, 0.0f));
+    add(m_pCounter);
     
     set(0, 0, 0);
 }
 
 
+std::vector<glm::vec2> HUD :: star_wrap(int star_lev) const {
+    auto size = m_pStarMaterial->texture()->size();
+    return Prefab::tile_wrap(
+        // Y Y (height is tile size for both dims)
+        uvec2(size.y, size.y),
+        // X Y
+        uvec2(size.x, size.y),
+        STAR_LEVELS[star_lev]
+    );
+}
+
+
 void HUD :: redraw() {
     auto sw = m_pWindow->size().x;
     auto sh = m_pWindow->size().y;
@@ -30,15 +60,15 @@ void HUD :: redraw() {
     auto ctext = m_pCanvas->context();
     m_pCanvas->clear(Color(0.0f, 0.0f, 0.0f, 0.0f));
     
-    auto layout = m_pCanvas->layout();
-    layout->set_wrap(Pango::WRAP_WORD);
-    
-    m_FontDesc = Pango::FontDescription("Press Start 2P " + to_string(sw / 36));
-    m_pCanvas->layout()->set_font_description(m_FontDesc);
-    
-    layout->set_text("  " + to_string(m_Stars) + "/" + to_string(m_MaxStars));
-    ctext->set_source_rgba(1.0, 1.0, 1.0, 0.75);
-    layout->show_in_cairo_context(ctext);
+    if (not m_Overlay.empty()) {
+        auto layout = m_pCanvas->layout();
+        layout->set_wrap(Pango::WRAP_WORD);
+        layout->set_font_description(m_FontDesc);
+        layout->set_text(m_Overlay);
+        ctext->set_source_rgba(1.0, 1.0, 1.0, 0.75);
+        ctext->move_to(sw / 64, sh / 8);
+        layout->show_in_cairo_context(ctext);
+    }
 
     m_pCanvas->dirty(true);
 }
@@ -52,32 +82,21 @@ void HUD :: logic_self(Freq::Time) {
 }
 
 
+void HUD :: overlay(const std::string& text) {
+    if (text == m_Overlay)
+        return;
+    m_Overlay = text;
+    m_bDirty = true;
+}
+
+
 void HUD :: set(int star_lev, int stars, int max_stars) {
     if (star_lev != m_StarLev) {
         m_StarLev = star_lev;
-        
-        auto sw = m_pWindow->size().x;
-        auto sh = m_pWindow->size().y;
-        auto mat = make_shared<MeshMaterial>("items.png", m_pCache);
-
-        if (m_pMesh)
-            m_pMesh->detach();
-
-        m_pMesh = make_shared<Mesh>(
-            make_shared<MeshGeometry>(Prefab::quad(vec2(sw / 24, sw / 24))),
-            vector<shared_ptr<IMeshModifier>>{
-                make_shared<Wrap>(Prefab::tile_wrap(
-                    // Y Y (height is tile size for both dims)
-                    uvec2(mat->texture()->size().y, mat->texture()->size().y),
-                    // X Y
-                    uvec2(mat->texture()->size().x, mat->texture()->size().y),
-                    STAR_LEVELS[m_StarLev]
-                ))
-            }, mat
-        );
-        add(m_pMesh);
+        m_pStarWrap->data() = star_wrap(m_StarLev);
+        m_pMesh->clear_cache();
     }
     m_Stars = stars;
     m_MaxStars = max_stars;
-    m_bDirty = true;
+    m_pCounter->set(to_string(m_Stars) + "/" + to_string(m_MaxStars));
 }
@@ -5,6 +5,7 @@
 #include "Qor/Window.h"
 #include "Qor/Canvas.h"
 #include "Qor/Input.h"
+#include "GlyphText.h"
 
 class HUD: public Node {
     public:
@@ -18,9 +19,13 @@ class HUD: public Node {
         virtual void logic_self(Freq::Time) override;
 
         void set(int star_lev, int stars, int max_stars);
+        // small debug text under the counter, e.g. profiler zones
+        void overlay(const std::string& text);
         
     private:
+        // the canvas only holds the overlay, the counter is glyph quads
         void redraw();
+        std::vector<glm::vec2> star_wrap(int star_lev) const;
 
         Window* m_pWindow = nullptr;
         Input* m_pInput = nullptr;
@@ -28,12 +33,16 @@ class HUD: public Node {
         Cache<Resource, std::string>* m_pCache;
         Pango::FontDescription m_FontDesc;
         std::shared_ptr<Mesh> m_pMesh;
+        std::shared_ptr<MeshMaterial> m_pStarMaterial;
+        std::shared_ptr<Wrap> m_pStarWrap;
+        std::shared_ptr<GlyphText> m_pCounter;
 
         bool m_bDirty = true;
 
         int m_StarLev = -1;
         int m_Stars = 0;
         int m_MaxStars = 0;
+        std::string m_Overlay;
 
         static const std::vector<int> STAR_LEVELS;
 };
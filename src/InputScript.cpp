@@ -0,0 +1,94 @@
+#include "InputScript.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "kit/log/log.h"
+
+using namespace std;
+
+
+InputScript :: InputScript(const std::string& fn) {
+    ifstream f(fn);
+    if (not f)
+        ERRORf(READ, "input script %s", fn);
+
+    string line;
+    while (getline(f, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        istringstream ss(line);
+        Event e = {0, 0};
+        if (not (ss >> e.tick))
+            ERRORf(PARSE, "input script %s: %s", fn % line);
+
+        string name;
+        while (ss >> name) {
+            int i = index(name);
+            if (i < 0)
+                ERRORf(PARSE, "input script %s: unknown button %s", fn % name);
+            e.held |= 1u << i;
+        }
+
+        if (not m_Events.empty() && e.tick < m_Events.back().tick)
+            ERRORf(PARSE, "input script %s: ticks out of order", fn);
+        m_Events.push_back(e);
+    }
+}
+
+
+const std::vector<std::string>& InputScript :: buttons() {
+    static const vector<string> names {
+        "left", "right", "up", "down", "jump", "shoot"
+    };
+    return names;
+}
+
+
+int InputScript :: index(const std::string& name) {
+    auto& names = buttons();
+    auto itr = std::find(names.begin(), names.end(), name);
+    return itr == names.end() ? -1 : (int)std::distance(names.begin(), itr);
+}
+
+
+void InputScript :: tick(unsigned t) {
+    while (m_Next < m_Events.size() && m_Events[m_Next].tick <= t)
+        m_Held = m_Events[m_Next++].held;
+}
+
+
+bool InputScript :: button(const std::string& name) const {
+    int i = index(name);
+    return i >= 0 && (m_Held & (1u << i));
+}
+
+
+void InputScript :: record(unsigned t, Controller* ctrl) {
+    unsigned held = 0;
+    auto& names = buttons();
+    for (unsigned i = 0; i < names.size(); ++i)
+        if (ctrl->button(names[i]))
+            held |= 1u << i;
+
+    if (held == m_Held && not m_Events.empty())
+        return;
+    m_Held = held;
+    m_Events.push_back(Event{t, held});
+}
+
+
+void InputScript :: save(const std::string& fn) const {
+    ofstream f(fn);
+    if (not f)
+        ERRORf(WRITE, "input script %s", fn);
+
+    auto& names = buttons();
+    for (auto&& e: m_Events) {
+        f << e.tick;
+        for (unsigned i = 0; i < names.size(); ++i)
+            if (e.held & (1u << i))
+                f << " " << names[i];
+        f << "\n";
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef INPUTSCRIPT_H_KD40WZ7N
+#define INPUTSCRIPT_H_KD40WZ7N
+
+#include <string>
+#include <vector>
+#include "Qor/Input.h"
+
+// Player button states over time, for replaying input without a controller.
+//
+// Stored as text, one line per change:
+//   <tick> <button> <button> ...
+// which holds exactly those buttons from that tick on.
+class InputScript {
+    public:
+        InputScript() {}
+        InputScript(const std::string& fn);
+        ~InputScript() {}
+
+        // buttons the player reads
+        static const std::vector<std::string>& buttons();
+
+        // seek playback to tick, which only moves forward
+        void tick(unsigned t);
+        bool button(const std::string& name) const;
+
+        // appends the controller state if it changed since the last record
+        void record(unsigned t, Controller* ctrl);
+        void save(const std::string& fn) const;
+
+        // tick of the last change
+        unsigned length() const { return m_Events.empty() ? 0 : m_Events.back().tick; }
+        bool empty() const { return m_Events.empty(); }
+
+    private:
+        struct Event {
+            unsigned tick;
+            unsigned held; // bit per buttons() entry
+        };
+
+        static int index(const std::string& name);
+
+        std::vector<Event> m_Events;
+        unsigned m_Next = 0;
+        unsigned m_Held = 0;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "KinematicBody.h"
+#include <cmath>
+
+using namespace std;
+using namespace glm;
+
+
+float KinematicBody :: sweep_axis(
+    const Box& box, unsigned axis, float d, const Box* blocker
+) const {
+    if (std::abs(d) < EPSILON)
+        return d;
+    const unsigned other = 1 - axis;
+
+    // the whole span in one query
+    Box span(box);
+    if (d > 0.0f)
+        span.max()[axis] += d;
+    else
+        span.min()[axis] += d;
+
+    // ledges are one way platforms, only landing on them counts
+    unsigned flags = CollisionGrid::STATIC;
+    if (axis == 1 && d > 0.0f)
+        flags |= CollisionGrid::LEDGE;
+
+    float reach = std::abs(d);
+    auto face = [&](const Box& mask){
+        // only faces side by side on the other axis, not just touching
+        if (mask.min()[other] >= box.max()[other] - EPSILON ||
+            mask.max()[other] <= box.min()[other] + EPSILON)
+            return;
+
+        float gap = d > 0.0f ?
+            mask.min()[axis] - box.max()[axis] :
+            box.min()[axis] - mask.max()[axis];
+        if (gap < -EPSILON)
+            return; // already inside it
+        reach = std::min(reach, std::max(gap, 0.0f));
+    };
+    if (m_pGrids)
+        for (auto&& grid: *m_pGrids)
+            grid->each(span, flags, [&face](const CollisionGrid::Cell& c){
+                face(c.mask);
+            });
+    if (blocker)
+        face(*blocker);
+    return d > 0.0f ? reach : -reach;
+}
+
+
+KinematicBody::Result KinematicBody :: sweep(
+    const Box& box, glm::vec3 delta, const Box* blocker
+) const {
+    Result r;
+    r.delta = delta;
+    if (not m_pGrids && not blocker)
+        return r;
+
+    // horizontal first, so landing next to a wall still slides down it
+    Box b(box);
+    r.delta.x = sweep_axis(b, 0, delta.x, blocker);
+    r.blocked_x = std::abs(r.delta.x - delta.x) > EPSILON;
+    b.min().x += r.delta.x;
+    b.max().x += r.delta.x;
+
+    r.delta.y = sweep_axis(b, 1, delta.y, blocker);
+    r.blocked_y = std::abs(r.delta.y - delta.y) > EPSILON;
+    return r;
+}
+
+
+KinematicBody::Result KinematicBody :: resolve(Node* blocker) {
+    Result r;
+    if (not m_pNode || not m_pMask || not m_pNode->num_snapshots())
+        return r;
+
+    auto old_pos = Matrix::translation(kit::safe_ptr(m_pNode->snapshot(0))->world_transform);
+    auto delta = m_pNode->position(Space::WORLD) - old_pos;
+    delta.z = 0.0f;
+
+    auto box = m_pMask->world_box();
+    box.min() -= delta;
+    box.max() -= delta;
+    if (blocker) {
+        auto solid = blocker->world_box();
+        r = sweep(box, delta, &solid);
+    } else
+        r = sweep(box, delta);
+    if (not r.blocked_x && not r.blocked_y)
+        return r;
+
+    m_pNode->position(m_pNode->position() + r.delta - delta);
+    auto v = m_pNode->velocity();
+    m_pNode->velocity(
+        r.blocked_x ? 0.0f : v.x,
+        r.blocked_y ? 0.0f : v.y,
+        v.z
+    );
+    return r;
+}
@@ -0,0 +1,59 @@
+#ifndef KINEMATICBODY_H_F8MV3QKE
+#define KINEMATICBODY_H_F8MV3QKE
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "CollisionGrid.h"
+
+// Moves a box through the collision grids, one axis at a time.  Each axis
+// is a single grid query over the swept span, and the box stops at the
+// nearest solid face ahead of it instead of being moved back and tested
+// again.  Ledges only stop downward motion that starts above them, and
+// cells the box already overlaps never block, so it can not get stuck.
+// Positions are world space, y grows downward.
+class KinematicBody {
+    public:
+        typedef std::vector<std::shared_ptr<CollisionGrid>> Grids;
+
+        struct Result {
+            glm::vec3 delta; // how far the box got
+            bool blocked_x = false;
+            bool blocked_y = false;
+        };
+
+        // node is what gets moved, mask the child whose box collides
+        KinematicBody(const Grids* grids, Node* node = nullptr, Node* mask = nullptr):
+            m_pGrids(grids),
+            m_pNode(node),
+            m_pMask(mask)
+        {}
+
+        void node(Node* node) { m_pNode = node; }
+        void mask(Node* mask) { m_pMask = mask; }
+        Node* node() const { return m_pNode; }
+        Node* mask() const { return m_pMask; }
+
+        // as far as box can go by delta, blocker is one more solid box
+        // that is not in the grids, like a closed door
+        Result sweep(const Box& box, glm::vec3 delta, const Box* blocker = nullptr) const;
+
+        // the node moved freely since its last snapshot, take back what went
+        // through tiles (and blocker's world box) and stop its velocity on
+        // the blocked axes.  The correction goes into the node's position
+        // and velocity as is, so its parent must not be rotated or scaled
+        Result resolve(Node* blocker = nullptr);
+
+    private:
+        // how far box can go by d (signed) along axis 0 or 1
+        float sweep_axis(const Box& box, unsigned axis, float d, const Box* blocker) const;
+
+        // faces closer than this still touch
+        static constexpr float EPSILON = 0.001f;
+
+        const Grids* m_pGrids;
+        Node* m_pNode;
+        Node* m_pMask;
+};
+
+#endif
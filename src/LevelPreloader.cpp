@@ -0,0 +1,78 @@
+#include "LevelPreloader.h"
+#include <fstream>
+
+using namespace std;
+
+
+LevelPreloader& LevelPreloader :: get() {
+    static LevelPreloader instance;
+    return instance;
+}
+
+
+LevelPreloader :: ~LevelPreloader() {
+    join();
+}
+
+
+void LevelPreloader :: join() {
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+
+void LevelPreloader :: start(Request req) {
+    join();
+    {
+        lock_guard<mutex> lock(m_Mutex);
+        m_pLevel.reset();
+    }
+
+    auto _this = this;
+    m_Thread = thread([_this, req]{
+        auto level = load(req);
+        lock_guard<mutex> lock(_this->m_Mutex);
+        _this->m_pLevel = level;
+    });
+}
+
+
+std::shared_ptr<LevelPreloader::Level> LevelPreloader :: take(const std::string& name) {
+    join();
+
+    lock_guard<mutex> lock(m_Mutex);
+    auto level = m_pLevel;
+    m_pLevel.reset();
+    if (level && level->name != name)
+        return nullptr;
+    return level;
+}
+
+
+std::shared_ptr<LevelPreloader::Level> LevelPreloader :: load(const Request& req) {
+    auto level = make_shared<Level>();
+    level->name = req.name;
+
+    // anything that fails here is loaded (and reported) again by Game
+    if (not req.map_file.empty()) {
+        try {
+            level->map_file = make_shared<MapFile>(req.map_file);
+        } catch(...) {}
+    }
+
+    for (auto&& fn: req.sprites) {
+        try {
+            level->sprites.push_back(SpriteDef::load(fn));
+        } catch(...) {}
+    }
+
+    // warm the file cache for what Qor loads itself
+    vector<char> buf(64 * 1024);
+    for (auto&& fn: req.files) {
+        ifstream f(fn, ios::binary);
+        while (f.read(buf.data(), buf.size()))
+            ;
+    }
+
+    return level;
+}
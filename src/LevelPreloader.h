@@ -0,0 +1,52 @@
+#ifndef LEVELPRELOADER_H_5HTX2CMB
+#define LEVELPRELOADER_H_5HTX2CMB
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MapFile.h"
+#include "SpriteDef.h"
+
+// Loads what the next level needs on a worker thread while Pregame is up.
+// Only file reads and parsing happen there (precompiled map, sprite json);
+// Game::preload() takes the results on the main thread, where everything
+// that touches GL is still built.
+class LevelPreloader {
+    public:
+        struct Level {
+            std::string name;
+            std::shared_ptr<MapFile> map_file;
+            std::vector<std::shared_ptr<const SpriteDef>> sprites;
+        };
+
+        struct Request {
+            std::string name;
+            std::string map_file; // empty if there is none
+            std::vector<std::string> sprites; // sprite json to parse
+            std::vector<std::string> files; // read ahead only
+        };
+
+        static LevelPreloader& get();
+
+        ~LevelPreloader();
+
+        // replaces any earlier request
+        void start(Request req);
+
+        // waits for the worker, returns nullptr unless it loaded this level
+        std::shared_ptr<Level> take(const std::string& name);
+
+    private:
+        LevelPreloader() {}
+        void join();
+        static std::shared_ptr<Level> load(const Request& req);
+
+        std::mutex m_Mutex;
+        std::thread m_Thread;
+        std::shared_ptr<Level> m_pLevel;
+};
+
+#endif
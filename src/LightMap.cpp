@@ -0,0 +1,190 @@
+#include "LightMap.h"
+#include <algorithm>
+#include <cmath>
+#include <GL/glew.h>
+
+using namespace std;
+using namespace glm;
+
+
+LightMap :: ~LightMap() {
+    if (m_Texture)
+        glDeleteTextures(1, &m_Texture);
+}
+
+
+void LightMap :: resize(glm::vec2 origin, glm::vec2 size, glm::vec2 tile_size) {
+    // a border texel all around stays black, so clamped samples
+    // outside the area get no light
+    m_TexelSize = tile_size / float(m_TexelsPerTile);
+    m_Origin = origin - m_TexelSize;
+    m_Size = uvec2(
+        std::max<unsigned>(std::ceil(size.x / m_TexelSize.x), 1) + 2,
+        std::max<unsigned>(std::ceil(size.y / m_TexelSize.y), 1) + 2
+    );
+    m_Texels.assign(m_Size.x * m_Size.y * 3, 0);
+    dirty(ivec2(0), ivec2(m_Size) - ivec2(1));
+}
+
+
+void LightMap :: fit(glm::vec2 tile_size) {
+    if (m_Lights.empty()) {
+        resize(vec2(0.0f), tile_size, tile_size);
+        return;
+    }
+
+    vec2 lo(m_Lights[0].pos), hi(m_Lights[0].pos);
+    for (auto&& l: m_Lights) {
+        lo = glm::min(lo, vec2(l.pos) - l.dist);
+        hi = glm::max(hi, vec2(l.pos) + l.dist);
+    }
+    resize(lo, hi - lo, tile_size);
+}
+
+
+unsigned LightMap :: add(glm::vec3 pos, glm::vec3 color, float dist) {
+    m_Lights.push_back(Light{pos, color, dist, true});
+    return m_Lights.size() - 1;
+}
+
+
+void LightMap :: enable(unsigned id, bool on) {
+    if (id >= m_Lights.size() || m_Lights[id].on == on)
+        return;
+    m_Lights[id].on = on;
+
+    ivec2 lo, hi;
+    reach(m_Lights[id], lo, hi);
+    bake(lo, hi);
+}
+
+
+void LightMap :: bake() {
+    bake(ivec2(1), ivec2(m_Size) - ivec2(2));
+}
+
+
+void LightMap :: reach(const Light& l, glm::ivec2& lo, glm::ivec2& hi) const {
+    vec2 p = vec2(l.pos) - m_Origin;
+    lo = glm::max(ivec2(glm::floor((p - l.dist) / m_TexelSize)), ivec2(1));
+    hi = glm::min(ivec2(glm::floor((p + l.dist) / m_TexelSize)), ivec2(m_Size) - ivec2(2));
+}
+
+
+void LightMap :: bake(glm::ivec2 lo, glm::ivec2 hi) {
+    if (lo.x > hi.x || lo.y > hi.y)
+        return;
+
+    // every light touching the rect, usually a handful
+    vector<const Light*> near;
+    for (auto&& l: m_Lights) {
+        if (not l.on)
+            continue;
+        ivec2 llo, lhi;
+        reach(l, llo, lhi);
+        if (llo.x <= hi.x && lhi.x >= lo.x && llo.y <= hi.y && lhi.y >= lo.y)
+            near.push_back(&l);
+    }
+
+    for (int y = lo.y; y <= hi.y; ++y)
+        for (int x = lo.x; x <= hi.x; ++x) {
+            vec2 p = m_Origin + (vec2(x, y) + 0.5f) * m_TexelSize;
+            vec3 c(0.0f);
+            // same falloff as the shaders, ambient term only since the
+            // lights sit in the plane of the tiles
+            for (auto&& l: near) {
+                float d = glm::length(vec2(l->pos) - p) / l->dist;
+                if (d < 1.0f)
+                    c += l->color * std::cos(d * float(M_PI) / 2.0f);
+            }
+            auto t = &m_Texels[(y * m_Size.x + x) * 3];
+            for (int i = 0; i < 3; ++i)
+                t[i] = uint8_t(std::min(c[i], 1.0f) * 255.0f + 0.5f);
+        }
+
+    dirty(lo, hi);
+}
+
+
+void LightMap :: dirty(glm::ivec2 lo, glm::ivec2 hi) {
+    if (m_bDirty) {
+        m_DirtyLo = glm::min(m_DirtyLo, lo);
+        m_DirtyHi = glm::max(m_DirtyHi, hi);
+    } else {
+        m_DirtyLo = lo;
+        m_DirtyHi = hi;
+        m_bDirty = true;
+    }
+}
+
+
+glm::vec3 LightMap :: sample(glm::vec2 world) const {
+    ivec2 t = ivec2(glm::floor((world - m_Origin) / m_TexelSize));
+    if (t.x < 0 || t.y < 0 || t.x >= (int)m_Size.x || t.y >= (int)m_Size.y)
+        return vec3(0.0f);
+    auto p = &m_Texels[(t.y * m_Size.x + t.x) * 3];
+    return vec3(p[0], p[1], p[2]) / 255.0f;
+}
+
+
+void LightMap :: apply() {
+    if (m_Texels.empty())
+        return;
+
+    glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+    // rgb rows are not 4 byte aligned, the old state is put back after
+    GLint align = 4;
+    if (not m_Texture || m_bDirty) {
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &align);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+    if (not m_Texture) {
+        glGenTextures(1, &m_Texture);
+        glBindTexture(GL_TEXTURE_2D, m_Texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_RGB8, m_Size.x, m_Size.y, 0,
+            GL_RGB, GL_UNSIGNED_BYTE, &m_Texels[0]
+        );
+        glPixelStorei(GL_UNPACK_ALIGNMENT, align);
+        m_bDirty = false;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, m_Texture);
+        if (m_bDirty) {
+            // row by row, the rect is narrower than the texture
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_Size.x);
+            glTexSubImage2D(
+                GL_TEXTURE_2D, 0,
+                m_DirtyLo.x, m_DirtyLo.y,
+                m_DirtyHi.x - m_DirtyLo.x + 1, m_DirtyHi.y - m_DirtyLo.y + 1,
+                GL_RGB, GL_UNSIGNED_BYTE,
+                &m_Texels[(m_DirtyLo.y * m_Size.x + m_DirtyLo.x) * 3]
+            );
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, align);
+            m_bDirty = false;
+        }
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    if (not program)
+        return;
+    if ((unsigned)program != m_Program) {
+        m_Program = program;
+        m_TextureLoc = glGetUniformLocation(program, "LightMap");
+        m_RectLoc = glGetUniformLocation(program, "LightMapRect");
+    }
+
+    if (m_TextureLoc >= 0)
+        glUniform1i(m_TextureLoc, TEXTURE_UNIT);
+    if (m_RectLoc >= 0)
+        glUniform4f(m_RectLoc,
+            m_Origin.x, m_Origin.y,
+            1.0f / (m_Size.x * m_TexelSize.x), 1.0f / (m_Size.y * m_TexelSize.y)
+        );
+}
@@ -0,0 +1,73 @@
+#ifndef LIGHTMAP_H_H3ZU6FPX
+#define LIGHTMAP_H_H3ZU6FPX
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Stationary point lights baked into one low resolution texture covering
+// the map, which the shaders sample once per fragment instead of looping
+// over these lights.  Falloff matches the dynamic lights.  Switching a
+// light off or on rebakes and reuploads only the texels it reaches.
+class LightMap {
+    public:
+        static const unsigned NONE = ~0u;
+        static const unsigned TEXTURE_UNIT = 7;
+
+        LightMap(unsigned texels_per_tile = 2):
+            m_TexelsPerTile(texels_per_tile)
+        {}
+        ~LightMap();
+
+        LightMap(const LightMap&) = delete;
+        LightMap& operator=(const LightMap&) = delete;
+
+        // world area in pixels, the texture adds a black texel around it
+        void resize(glm::vec2 origin, glm::vec2 size, glm::vec2 tile_size);
+        // just the area the lights reach
+        void fit(glm::vec2 tile_size);
+
+        // position in world space, returns an id for enable()
+        unsigned add(glm::vec3 pos, glm::vec3 color, float dist);
+        void enable(unsigned id, bool on);
+        void bake();
+
+        glm::uvec2 size() const { return m_Size; }
+        unsigned lights() const { return m_Lights.size(); }
+        glm::vec3 sample(glm::vec2 world) const;
+
+        // GL side, needs a context: uploads whatever changed, then binds
+        // the texture and sets the uniforms of the current program
+        void apply();
+
+    private:
+        struct Light {
+            glm::vec3 pos;
+            glm::vec3 color;
+            float dist;
+            bool on;
+        };
+
+        // texel rect a light reaches, clamped to inside the border
+        void reach(const Light& l, glm::ivec2& lo, glm::ivec2& hi) const;
+        void bake(glm::ivec2 lo, glm::ivec2 hi);
+        void dirty(glm::ivec2 lo, glm::ivec2 hi);
+
+        unsigned m_TexelsPerTile;
+        glm::vec2 m_Origin;
+        glm::vec2 m_TexelSize = glm::vec2(1.0f);
+        glm::uvec2 m_Size = glm::uvec2(0);
+        std::vector<Light> m_Lights;
+        std::vector<uint8_t> m_Texels; // rgb
+
+        // texels changed since the last upload
+        bool m_bDirty = false;
+        glm::ivec2 m_DirtyLo, m_DirtyHi;
+
+        unsigned m_Texture = 0;
+        unsigned m_Program = 0;
+        int m_TextureLoc = -1;
+        int m_RectLoc = -1;
+};
+
+#endif
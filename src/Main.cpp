@@ -26,7 +26,8 @@ int main(int argc, const char** argv) {
         engine->states().register_class<Intro>("intro");
         engine->states().register_class<Pregame>("pregame");
         engine->states().register_class<Game>("game");
-        engine->run("intro");
+        // headless runs skip straight to the level
+        engine->run(args.has("--headless") ? "game" : "intro");
 
 #ifndef DEBUG
     } catch (const Error&) {
@@ -0,0 +1,213 @@
+#include "MapFile.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include "kit/log/log.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+
+namespace {
+    uint32_t align4(uint32_t n) {
+        return (n + 3u) & ~3u;
+    }
+
+    // string table builder, equal strings share an offset
+    struct Strings {
+        uint32_t add(const string& s) {
+            auto itr = offsets.find(s);
+            if (itr != offsets.end())
+                return itr->second;
+            uint32_t r = data.size();
+            data.insert(data.end(), s.begin(), s.end());
+            data.push_back('\0');
+            offsets[s] = r;
+            return r;
+        }
+        vector<char> data;
+        map<string, uint32_t> offsets;
+    };
+}
+
+
+void MapFile :: write(const std::string& fn, const Source& src) {
+    const uint32_t cells = src.width * src.height;
+    Strings strings;
+    strings.add(""); // offset 0 is the empty string
+
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.width = src.width;
+    header.height = src.height;
+    header.tile_width = src.tile_width;
+    header.tile_height = src.tile_height;
+    header.layers = src.layers.size();
+    header.spawns = src.spawns.size();
+
+    uint32_t offset = sizeof(Header) +
+        header.layers * sizeof(Layer) +
+        header.spawns * sizeof(Spawn);
+
+    vector<Layer> layers;
+    for (auto&& l: src.layers) {
+        if (l.tiles.size() != cells || l.cells.size() != cells)
+            ERRORf(GENERAL, "map layer %s does not match map size", layers.size());
+
+        Layer r;
+        r.tiles = offset;
+        offset += cells * sizeof(uint32_t);
+        r.cells = offset;
+        offset = align4(offset + cells);
+        layers.push_back(r);
+    }
+
+    vector<Spawn> spawns;
+    for (auto&& s: src.spawns)
+        spawns.push_back(Spawn{
+            s.gid,
+            strings.add(s.name),
+            strings.add(s.type)
+        });
+
+    header.strings = offset;
+    header.size = offset + strings.data.size();
+
+    ofstream f(fn, ios::binary);
+    if (not f)
+        ERRORf(WRITE, "map file %s", fn);
+
+    const char pad[4] = {0, 0, 0, 0};
+    f.write((const char*)&header, sizeof(header));
+    f.write((const char*)layers.data(), layers.size() * sizeof(Layer));
+    f.write((const char*)spawns.data(), spawns.size() * sizeof(Spawn));
+    for (auto&& l: src.layers) {
+        f.write((const char*)l.tiles.data(), cells * sizeof(uint32_t));
+        f.write((const char*)l.cells.data(), cells);
+        f.write(pad, align4(cells) - cells);
+    }
+    f.write(strings.data.data(), strings.data.size());
+
+    if (not f)
+        ERRORf(WRITE, "map file %s", fn);
+}
+
+
+MapFile :: MapFile(const std::string& fn) {
+#ifdef _WIN32
+    m_File = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE) {
+        m_File = nullptr;
+        ERRORf(READ, "map file %s", fn);
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(m_File, &size);
+    m_Size = (size_t)size.QuadPart;
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_Mapping)
+        m_pData = (const uint8_t*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (not m_pData) {
+        close();
+        ERRORf(READ, "map file %s", fn);
+    }
+#else
+    m_File = open(fn.c_str(), O_RDONLY);
+    if (m_File < 0)
+        ERRORf(READ, "map file %s", fn);
+    struct stat st;
+    if (fstat(m_File, &st) == 0 && st.st_size > 0) {
+        m_Size = st.st_size;
+        void* p = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+        if (p != MAP_FAILED)
+            m_pData = (const uint8_t*)p;
+    }
+    if (not m_pData) {
+        close();
+        ERRORf(READ, "map file %s", fn);
+    }
+#endif
+
+    try {
+        validate(fn);
+    } catch(...) {
+        close();
+        throw;
+    }
+
+    m_pHeader = (const Header*)m_pData;
+    m_pLayers = (const Layer*)(m_pData + sizeof(Header));
+    m_pSpawns = (const Spawn*)(m_pLayers + m_pHeader->layers);
+}
+
+
+MapFile :: ~MapFile() {
+    close();
+}
+
+
+void MapFile :: close() {
+#ifdef _WIN32
+    if (m_pData)
+        UnmapViewOfFile(m_pData);
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+    if (m_File)
+        CloseHandle(m_File);
+    m_Mapping = nullptr;
+    m_File = nullptr;
+#else
+    if (m_pData)
+        munmap((void*)m_pData, m_Size);
+    if (m_File >= 0)
+        ::close(m_File);
+    m_File = -1;
+#endif
+    m_pData = nullptr;
+}
+
+
+void MapFile :: validate(const std::string& fn) const {
+    auto h = (const Header*)m_pData;
+    if (m_Size < sizeof(Header) || h->magic != MAGIC)
+        ERRORf(PARSE, "map file %s: not a map file", fn);
+    if (h->version != VERSION)
+        ERRORf(PARSE, "map file %s: version %s, expected %s", fn % h->version % VERSION);
+    if (h->size != m_Size || h->strings > m_Size)
+        ERRORf(PARSE, "map file %s: truncated", fn);
+
+    // every table and array has to be inside the file
+    uint64_t cells = (uint64_t)h->width * h->height;
+    uint64_t tables = sizeof(Header) +
+        (uint64_t)h->layers * sizeof(Layer) +
+        (uint64_t)h->spawns * sizeof(Spawn);
+    if (tables > h->strings)
+        ERRORf(PARSE, "map file %s: truncated", fn);
+
+    auto layers = (const Layer*)(m_pData + sizeof(Header));
+    for (uint32_t i = 0; i < h->layers; ++i) {
+        if (layers[i].tiles % 4 ||
+            layers[i].tiles + cells * sizeof(uint32_t) > h->strings ||
+            layers[i].cells + cells > h->strings
+        )
+            ERRORf(PARSE, "map file %s: bad layer", fn);
+    }
+
+    if (h->size == h->strings || m_pData[h->size - 1] != '\0')
+        ERRORf(PARSE, "map file %s: bad string table", fn);
+
+    uint32_t strings = h->size - h->strings;
+    auto spawns = (const Spawn*)(layers + h->layers);
+    for (uint32_t i = 0; i < h->spawns; ++i)
+        if (spawns[i].name >= strings || spawns[i].type >= strings)
+            ERRORf(PARSE, "map file %s: bad spawn", fn);
+}
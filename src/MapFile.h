@@ -0,0 +1,125 @@
+#ifndef MAPFILE_H_J7YB3QE0
+#define MAPFILE_H_J7YB3QE0
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Precompiled map, written by the mapc tool from a .tmx and its tileset
+// json, and mapped straight into memory by the game.  Only what Game reads
+// instead of tile properties is kept: collision flags and gids of the tile
+// layers, and the entity name of each gid.  Qor still loads the tmx itself.
+//
+// Layout (little endian, every section 4 byte aligned):
+//   Header
+//   Layer[layers]
+//   Spawn[spawns]
+//   per layer: uint32_t gid[width * height], uint8_t flags[width * height]
+//   string table, null terminated, referenced by offset
+class MapFile {
+    public:
+        // cell flags, same bits as CollisionGrid::Flag
+        enum Flag {
+            OCCUPIED = 1 << 0,
+            STATIC = 1 << 1,
+            LEDGE = 1 << 2,
+            FATAL = 1 << 3
+        };
+
+        static const uint32_t MAGIC = 0x504d414d; // "MAMP"
+        static const uint32_t VERSION = 2;
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t tile_width;
+            uint32_t tile_height;
+            uint32_t layers;
+            uint32_t spawns;
+            uint32_t strings; // offset of the string table
+            uint32_t size; // total file size
+        };
+
+        // tile layers only, in tmx order
+        struct Layer {
+            uint32_t tiles; // offset of gid array
+            uint32_t cells; // offset of flag array
+        };
+
+        // a gid whose tiles become entities (player spawn, thing or
+        // monster), once per gid
+        struct Spawn {
+            uint32_t gid;
+            uint32_t name;
+            uint32_t type; // empty string if untyped
+        };
+
+        // what mapc fills in before write()
+        struct Source {
+            struct Layer {
+                std::vector<uint32_t> tiles;
+                std::vector<uint8_t> cells;
+            };
+            struct Spawn {
+                uint32_t gid;
+                std::string name;
+                std::string type;
+            };
+
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t tile_width = 16;
+            uint32_t tile_height = 16;
+            std::vector<Layer> layers;
+            std::vector<Spawn> spawns;
+        };
+
+        static void write(const std::string& fn, const Source& src);
+
+        MapFile(const std::string& fn);
+        ~MapFile();
+
+        MapFile(const MapFile&) = delete;
+        MapFile& operator=(const MapFile&) = delete;
+
+        const Header& header() const { return *m_pHeader; }
+        uint32_t width() const { return m_pHeader->width; }
+        uint32_t height() const { return m_pHeader->height; }
+
+        uint32_t layers() const { return m_pHeader->layers; }
+        const Layer& layer(uint32_t i) const { return m_pLayers[i]; }
+        const uint32_t* tiles(uint32_t i) const {
+            return (const uint32_t*)(m_pData + m_pLayers[i].tiles);
+        }
+        const uint8_t* cells(uint32_t i) const {
+            return m_pData + m_pLayers[i].cells;
+        }
+
+        uint32_t spawns() const { return m_pHeader->spawns; }
+        const Spawn& spawn(uint32_t i) const { return m_pSpawns[i]; }
+
+        const char* str(uint32_t offset) const {
+            return (const char*)(m_pData + m_pHeader->strings + offset);
+        }
+
+    private:
+        void validate(const std::string& fn) const;
+        void close();
+
+        const uint8_t* m_pData = nullptr;
+        size_t m_Size = 0;
+        const Header* m_pHeader = nullptr;
+        const Layer* m_pLayers = nullptr;
+        const Spawn* m_pSpawns = nullptr;
+
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#else
+        int m_File = -1;
+#endif
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "Mixer.h"
+#include "kit/kit.h"
+
+using namespace std;
+using namespace glm;
+
+
+Mixer :: Mixer(Cache<Resource, std::string>* resources, unsigned voices):
+    m_pResources(resources),
+    m_Voices(voices)
+{
+    for (auto&& v: m_Voices)
+        v.source = kit::make_unique<Audio::Source>();
+}
+
+
+Mixer :: ~Mixer() {
+    stop();
+}
+
+
+Mixer::Handle Mixer :: sample(
+    const std::string& fn,
+    unsigned limit,
+    int priority,
+    Policy policy
+){
+    auto itr = m_Names.find(fn);
+    if (itr != m_Names.end())
+        return itr->second;
+
+    Handle h = m_Samples.size();
+    m_Samples.push_back(Sample{
+        fn,
+        m_pResources->cache_as<Audio::Buffer>(fn),
+        std::max(limit, 1u),
+        priority,
+        policy
+    });
+    m_Names[fn] = h;
+    return h;
+}
+
+
+bool Mixer :: busy(Voice& v) {
+    if (v.sample == NONE)
+        return false;
+    if (v.source->playing())
+        return true;
+    v.sample = NONE;
+    return false;
+}
+
+
+void Mixer :: start(Voice& v, Handle h, glm::vec3 pos) {
+    auto& s = m_Samples[h];
+    if (busy(v))
+        v.source->stop();
+
+    v.sample = h;
+    v.priority = s.priority;
+    v.started = ++m_Started;
+
+    v.source->bind(s.buffer.get());
+    v.source->pos = pos;
+    v.source->gain = m_Gain;
+    v.source->refresh();
+    v.source->play();
+}
+
+
+bool Mixer :: play(Handle h, glm::vec3 pos) {
+    if (h >= m_Samples.size())
+        return false;
+    auto& s = m_Samples[h];
+
+    Voice* free_voice = nullptr;
+    Voice* own_oldest = nullptr; // of this sample
+    Voice* victim = nullptr; // lowest priority, then oldest
+    unsigned instances = 0;
+
+    for (auto&& v: m_Voices) {
+        if (not busy(v)) {
+            if (not free_voice)
+                free_voice = &v;
+            continue;
+        }
+
+        if (v.sample == h) {
+            ++instances;
+            if (not own_oldest || v.started < own_oldest->started)
+                own_oldest = &v;
+        }
+
+        if (v.priority <= s.priority && (
+            not victim ||
+            v.priority < victim->priority ||
+            (v.priority == victim->priority && v.started < victim->started)
+        ))
+            victim = &v;
+    }
+
+    if (instances >= s.limit) {
+        if (s.policy == DROP) {
+            ++m_Drops;
+            return false;
+        }
+        start(*own_oldest, h, pos);
+        return true;
+    }
+
+    if (free_voice) {
+        start(*free_voice, h, pos);
+        return true;
+    }
+
+    if (victim) {
+        ++m_Steals;
+        start(*victim, h, pos);
+        return true;
+    }
+
+    ++m_Drops;
+    return false;
+}
+
+
+void Mixer :: stop() {
+    for (auto&& v: m_Voices)
+        if (busy(v)) {
+            v.source->stop();
+            v.sample = NONE;
+        }
+}
+
+
+unsigned Mixer :: playing(Handle h) const {
+    unsigned n = 0;
+    for (auto&& v: m_Voices)
+        if (v.sample == h && v.source->playing())
+            ++n;
+    return n;
+}
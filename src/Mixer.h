@@ -0,0 +1,86 @@
+#ifndef MIXER_H_W9KE4RVA
+#define MIXER_H_W9KE4RVA
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Qor/Audio.h"
+#include "Qor/Resource.h"
+
+// Fixed pool of audio voices for short sound effects.  Samples are
+// registered once (decoding and caching their buffer) and then played by
+// handle, which binds the buffer to a free voice instead of creating a
+// Sound node.  Each sample has a limit on how many voices it may hold at
+// once, and when every voice is busy the oldest voice of the lowest
+// priority at or below the new sound's is stolen.
+class Mixer {
+    public:
+        typedef unsigned Handle;
+        static const Handle NONE = ~0u;
+        static const unsigned DEFAULT_VOICES = 16;
+
+        enum Policy {
+            DROP, // at its limit, the new sound is not played
+            RESTART // at its limit, the sample's oldest voice starts over
+        };
+
+        Mixer(Cache<Resource, std::string>* resources, unsigned voices = DEFAULT_VOICES);
+        ~Mixer();
+
+        Mixer(const Mixer&) = delete;
+        Mixer& operator=(const Mixer&) = delete;
+
+        // registering the same file again returns the same handle
+        Handle sample(
+            const std::string& fn,
+            unsigned limit = 4,
+            int priority = 0,
+            Policy policy = RESTART
+        );
+
+        // false if the sound was dropped
+        bool play(Handle h, glm::vec3 pos = glm::vec3(0.0f));
+        void stop();
+
+        // scales every voice, from the audio config
+        void gain(float g) { m_Gain = g; }
+        float gain() const { return m_Gain; }
+
+        unsigned voices() const { return m_Voices.size(); }
+        unsigned playing(Handle h) const;
+        unsigned steals() const { return m_Steals; }
+        unsigned drops() const { return m_Drops; }
+
+    private:
+        struct Sample {
+            std::string fn;
+            std::shared_ptr<Audio::Buffer> buffer;
+            unsigned limit;
+            int priority;
+            Policy policy;
+        };
+
+        struct Voice {
+            std::unique_ptr<Audio::Source> source;
+            Handle sample = NONE;
+            int priority = 0;
+            unsigned started = 0; // play order, for finding the oldest
+        };
+
+        // voices whose sound ended are freed here, lazily
+        bool busy(Voice& v);
+        void start(Voice& v, Handle h, glm::vec3 pos);
+
+        Cache<Resource, std::string>* m_pResources = nullptr;
+        std::vector<Sample> m_Samples;
+        std::unordered_map<std::string, Handle> m_Names;
+        std::vector<Voice> m_Voices;
+        float m_Gain = 1.0f;
+        unsigned m_Started = 0;
+        unsigned m_Steals = 0;
+        unsigned m_Drops = 0;
+};
+
+#endif
@@ -4,6 +4,10 @@
 #include "Qor/TileMap.h" 
 #include "Qor/Sprite.h"
 #include "Player.h"
+#include "CollisionGrid.h"
+#include "BulletPool.h"
+#include "ParticleSystem.h"
+#include "FireChain.h"
 #include "kit/math/vectorops.h"
 #include "kit/kit.h"
 
@@ -26,11 +30,12 @@ Monster :: Monster(
     m_pGame(game),                                  // Set Monster Game
     m_pMap(map),                                    // Set Monster Map
     m_pResources(resources),                        // Set Monster Resources
-    m_MonsterID(get_type(config)),                  // Set Monster Type (int)
+    m_MonsterID(game->entities().type(config).id),  // Set Monster Type (int)
     m_Identity(config->at<string>("name", "")),     // Set Monster Type (String)
     m_StunTimer(timeline),                          // Set Monster Stun Time (Alarm)
     m_pTimeline(timeline),                          // Set Timeline
-    m_ShootTimer(&m_LazyTimeline)
+    m_ShootTimer(&m_LazyTimeline),
+    m_Body(&game->collision_grids(), this)          // Set Monster Body (Tile Sweeps)
 {}
 
 
@@ -46,50 +51,77 @@ const vector<string> Monster :: s_TypeNames({
 });
 
 
-// Find the Monster Type enum value
-unsigned Monster :: get_type(const shared_ptr<Meta>& config) {
-    string name = config->at<string>("name", "");
-    
-    if (name.empty())
-        return 0;
-
-    // Determines if the name is in the Monster Typenames vector
-    auto itr = std::find(ENTIRE(s_TypeNames), name);
-    if (itr == s_TypeNames.end())
-        return 0;
-    
-    return std::distance(s_TypeNames.begin(), itr);
-}
+void Monster :: logic_self(Freq::Time t) {
+    // asleep, only the patrol step runs: no snapshots, timers or attacks
+    if (not m_bAwake) {
+        patrol();
+        return;
+    }
 
+    PROFILE_ZONE("monster logic");
 
-void Monster :: logic_self(Freq::Time t) {
     clear_snapshots();
     snapshot();
     
     // why is this here instead of a signal/slot in stun?
     if (m_StunTimer.elapsed()) {
-        m_pSprite->set_state("unhit");
+        state(m_State.unhit);
         m_StunTimer.reset();
     }
 
-    // if a player is within range of monster, set active
-    auto players = m_pGame->players();
-    float min_dist = 10000.0f;
+    think(t);
+    patrol();
+}
 
-    Player* closest_player = nullptr;
-    for(auto&& player: players)
-    {
-        auto dist = glm::length(
-            player->position(Space::WORLD) - position(Space::WORLD)
-        );
-        if(dist < min_dist){
-            min_dist = dist;
-            closest_player = player.get();
+
+void Monster :: patrol() {
+    // turn around at ledges, and at walls while asleep since the body
+    // has no snapshot to resolve against then
+    auto layer = (TileLayer*)parent();
+    auto grid = m_pGame->collision_grid(layer);
+    auto ground = [layer, grid](int x, int y) -> bool {
+        return grid ? grid->occupied(x, y) : layer->tile(x, y) != nullptr;
+    };
+    auto vel = velocity();
+    auto ts = layer->map()->tile_size();
+    int row = position().y / ts.y;
+    if(vel.x < -K_EPSILON) {
+        int x = (int)std::round(position().x / ts.x - 0.5); // -
+        if (not ground(x, row + 1) || (not m_bAwake && ground(x, row))) {
+            state(m_State.right);
+            velocity(-vel.x, vel.y, vel.z);
+        }
+    }
+    else if(vel.x > K_EPSILON) {
+        int x = (int)std::round(position().x / ts.x + 0.5); // +
+        if (not ground(x, row + 1) || (not m_bAwake && ground(x, row))) {
+            state(m_State.left);
+            velocity(-vel.x, vel.y, vel.z);
         }
     }
 
+    // Why not in damage?
+    if (not is_alive()) {
+        m_pGame->remove_monster(this);
+        if (m_pFire) {
+            m_pFire->stop();
+            m_pFire->safe_detach();
+        }
+        detach();
+    } else {
+        m_pGame->monster_moved(this);
+    }
+}
+
+
+void Monster :: think(Freq::Time t) {
+    // if a player is within range of monster, set active
+    Player* closest_player = m_pGame->closest_player(
+        position(Space::WORLD), ACTIVATION_RADIUS
+    );
+
     bool old_active = m_bActive;
-    m_bActive = (min_dist < 100.0f);
+    m_bActive = (closest_player != nullptr);
     if(old_active != m_bActive)
     {
         if(m_bActive)
@@ -116,28 +148,6 @@ void Monster :: logic_self(Freq::Time t) {
         }
 
     }
-
-    auto layer = (TileLayer*)parent();
-    auto vel = velocity();
-    if(vel.x < -K_EPSILON && not layer->tile(
-        (int)std::round(position().x / layer->map()->tile_size().x - 0.5), // -
-        position().y / layer->map()->tile_size().y + 1
-    )) {
-        m_pSprite->set_state("right");
-        velocity(-vel.x, vel.y, vel.z);
-    }
-    else if(vel.x > K_EPSILON && not layer->tile(
-        (int)std::round(position().x / layer->map()->tile_size().x + 0.5), // +
-        position().y / layer->map()->tile_size().y + 1
-    )) {
-        m_pSprite->set_state("left");
-        velocity(-vel.x, vel.y, vel.z);
-    }
-
-
-    // Why not in damage?
-    if (not is_alive())
-        detach();
 }
 
 
@@ -148,15 +158,11 @@ void Monster :: initialize() {
 
     //m_pPartitioner->register_object(shared_from_this(), Game::MONSTER);
 
-    TRY(m_pConfig->merge(make_shared<Meta>(
-        m_pResources->transform(m_Identity + ".json")
-    )));
-    
-    auto mask = m_pConfig->meta("mask");
-    m_Box = Box(
-        vec3(mask->at<double>(0), mask->at<double>(1), -0.5f),
-        vec3(mask->at<double>(2), mask->at<double>(3), 0.5f)
-    );
+    m_pDef = m_pGame->sprite_def(m_pResources->transform(m_Identity + ".json"));
+    if (m_pDef) {
+        TRY(m_pConfig->merge(m_pDef->config));
+        m_Box = m_pDef->mask;
+    }
     
     //m_Box = Box(
     //    vec3(
@@ -202,9 +208,9 @@ void Monster :: initialize() {
     //m_pPartitioner->register_object(m_pLeft, Game::SENSOR);
     //m_pPartitioner->register_object(m_pRight, Game::SENSOR);
 
-    m_HP = m_pConfig->at<int>("hp", 5);
-    m_MaxHP = m_pConfig->at<int>("hp", 5);
-    m_StartSpeed = m_pConfig->at<double>("speed", 10.0);
+    // the tile's own hp and speed win over its type's
+    m_HP = m_MaxHP = m_pConfig->at<int>("hp", m_pDef ? m_pDef->hp : 5);
+    m_StartSpeed = m_pConfig->at<double>("speed", m_pDef ? m_pDef->speed : 10.0);
     m_Speed = m_StartSpeed;
 
     m_pSprite = make_shared<Sprite>(
@@ -215,6 +221,12 @@ void Monster :: initialize() {
     add(m_pSprite);
 
     m_pSprite->set_states({"unhit", "left"});
+    m_States.reset(m_pDef);
+    m_States.init({"unhit", "left"});
+    m_State = {
+        m_States.id("left"), m_States.id("right"),
+        m_States.id("hit"), m_States.id("unhit")
+    };
     if (m_pPlaceholder->tile_layer()->depth() || m_pConfig->has("depth"))
         m_pSprite->mesh()->set_geometry(m_pMap->tilted_tile_geometry());
 
@@ -236,8 +248,22 @@ void Monster :: initialize() {
     m_pSprite->mesh()->config()->set<string>("id", m_Identity);
     m_pSprite->mesh()->config()->set<Monster*>("monster", this);
     m_pSprite->mesh()->set_box(m_Box);
+    m_Colliders.body = m_pSprite->mesh().get();
+    m_Body.mask(m_Colliders.body);
     m_pPartitioner->register_object(m_pSprite->mesh(), Game::MONSTER);
 
+    // flames stay where they were cast, like the collapsed fire sprites did
+    if (m_MonsterID == Monster::WIZARD) {
+        m_pFire = make_shared<FireChain>(
+            m_pResources, m_pPartitioner, Game::FATAL, this
+        );
+        auto game = m_pGame;
+        m_pFire->on_spread = [game](vec3 pos){
+            game->embers()->burst(pos, 2, 20.0f, 0.5f, 3.0f);
+        };
+        parent()->add(m_pFire);
+    }
+
     velocity(vec3(-m_Speed, 0.0f, 0.0f));
 }
 
@@ -259,9 +285,9 @@ void Monster :: activate(Player* closest_player) {
         vel.z
     );
     if(velocity().x < -K_EPSILON)
-        sprite()->set_state("left");
+        state(m_State.left);
     else if(velocity().x > K_EPSILON)
-        sprite()->set_state("right");
+        state(m_State.right);
 }
 
 
@@ -271,6 +297,24 @@ void Monster :: deactivate(Player* closest_player) {
 }
 
 
+void Monster :: sleep() {
+    if (not m_bAwake)
+        return;
+
+    m_bAwake = false;
+    // resolve() would take the whole nap back from a stale snapshot
+    clear_snapshots();
+}
+
+
+void Monster :: wake() {
+    if (m_bAwake)
+        return;
+
+    m_bAwake = true;
+}
+
+
 void Monster :: damage(int dmg) {
     if (m_HP > 0 and dmg > 0) {
         m_HP = std::max(m_HP - dmg, 0);
@@ -286,149 +330,57 @@ void Monster :: damage(int dmg) {
 void Monster :: shoot(float bullet_speed, glm::vec3 offset, int life) {
 
     if (m_MonsterID == Monster::WIZARD) {
-
-        // Load fire sprite
-        auto fire = make_shared<Sprite>(m_pResources->transform("fire.json"), m_pResources);
-        fire->set_state("animated");
-
-        auto firebox = fire->mesh()->box();
-        fire->mesh()->set_box(Box(
-            vec3(firebox.min().x, firebox.min().y, -5.0),
-            vec3(firebox.max().x, firebox.max().y, 5.0)
-        ));
-        
-        add(fire);
-        fire->collapse();
-
-        m_pPartitioner->register_object(fire->mesh(), Game::FATAL);
-        
-        offset.x += kit::sign(velocity().x) * float(fire->size().x);
-        fire->position(fire->position() + offset);
-        
-        auto spawn_timer = make_shared<Freq::Alarm>(m_pTimeline);
-        spawn_timer->set(Freq::Time::seconds(0.05f));
-        auto death_timer = make_shared<Freq::Alarm>(m_pTimeline);
-        death_timer->set(Freq::Time::seconds(0.5f));
-        
-        Sound::play(m_pSprite.get(), "fire.wav", m_pResources);
-
-        auto _this = this;
-        auto fireptr = fire.get();
-        auto origin = m_pSprite.get();
-        //fireptr->on_tick.connect_extended([
-        auto part = m_pPartitioner;
-        fireptr->on_tick.connect([
-            _this, spawn_timer, death_timer, bullet_speed, offset, fireptr,
-            origin, life, part
-        //](boost::signals2::connection con, Freq::Time t){
-        ](Freq::Time t){
-            //auto fire = firew.lock();
-            //if(not fire){
-            //    con.disconnect();
-            //    return;
-            //}
-        
-            if(spawn_timer->elapsed()){
-                if(life > 0)
-                    _this->shoot(bullet_speed, offset, life-1);
-                spawn_timer->reset();
-            }
-            if(death_timer->elapsed()){
-                fireptr->safe_detach();
-                //part->after([fireptr]{
-                //});
-                //con.disconnect();
-            }
-        });
-        //fire->on_tick.connect([fireptr, death_timer](Freq::Time){
-        //    if(death_timer->elapsed()){
-        //        fireptr->safe_detach();
-        //    }
-        //});
+        // a trail of life more flames spreading the way we walk
+        if (m_pFire) {
+            m_pGame->sound(m_pGame->sounds().fire, m_pSprite.get());
+            m_pFire->start(offset, kit::sign(velocity().x), life);
+        }
     }
 
     else {
-        // Create a bullet mesh
-        auto shot = make_shared<Mesh>(
-            make_shared<MeshGeometry>(Prefab::quad(glm::vec2(8.0f, 2.0f))),
-            vector<shared_ptr<IMeshModifier>>{make_shared<Wrap>(Prefab::quad_wrap(vec2(0.0f, 1.0f), vec2(1.0f, 0.0f)))},
-            make_shared<MeshMaterial>("laser.png", m_pResources)
-        );
-
-        m_pPartitioner->register_object(shot, Game::BULLET);
-        shot->config()->set<Monster*>("monster",this);
-
-        // Creates a box around the bullet (With increased z width)
-        auto shotbox = shot->box();
-        shot->set_box(Box(
-            vec3(shotbox.min().x, shotbox.min().y, -5.0),
-            vec3(shotbox.max().x, shotbox.max().y, 5.0)
-        ));
+        // Take a bullet from the pool, it expires after 0.5 seconds
+        auto shot = m_pGame->bullets()->spawn(BulletPool::MONSTER, 0.5f);
+        shot->owner(this);
 
         // Add the bullet to the parent
         //auto par = m_pSprite->parent();
         //par->add(shot);
-        stick(shot);
+        stick(shot->as_node());
         shot->move(vec3(0.0f, -m_pSprite->mesh()->world_box().size().y / 2.0f, 0.0f));
 
         // Add a random angle to the bullet
         shot->rotate(((rand() % 10) - 5) / 360.0f, vec3(0.0f, 0.0f, 1.0f));
         shot->velocity(shot->orient_to_world(
-            vec3((m_pSprite->check_state("left") ? -1.0f : 1.0f) * bullet_speed, 0.0f, 0.0f)
+            vec3((m_States.is(m_State.left) ? -1.0f : 1.0f) * bullet_speed, 0.0f, 0.0f)
         ));
 
-        // Sets timer for bullets before disappearing
-        auto timer = make_shared<Freq::Alarm>(m_pTimeline);
-        timer->set(Freq::Time::seconds(0.5f));
-
-        Sound::play(m_pSprite.get(), "shoot.wav", m_pResources);
-
-        // Connects shot to a game tick signal
-        auto shotptr = shot.get();
-        shot->on_tick.connect([timer, shotptr](Freq::Time t){
-            if (timer->elapsed())
-                shotptr->detach();
-        });
+        m_pGame->sound(m_pGame->sounds().shoot, m_pSprite.get());
     }
 }
 
 
 void Monster :: stun(int stun_time=DEFAULT_STUN_TIME) {
-    m_pSprite->set_state("hit");
+    state(m_State.hit);
     m_StunTimer.set(Freq::Time::ms(stun_time));
 }
 
 
 void Monster :: gib() {
-    auto gib = make_shared<Sprite>(m_pResources->transform("blood.json"), m_pResources);
-    gib->set_state("animated");
-    
     // Randomizes direction gib moves
     auto dir = Angle::degrees(1.0f * (rand() % 360)).vector();
-    stick(gib);
-
-    // Sets gib size and movement
-    gib->move(vec3(rand() % 16 - 8.0f, rand() % 32 - 16.0f, 2.0f));
-    gib->velocity(vec3(dir, 0.0f) * 100.0f);
-    gib->acceleration(vec3(0.0f, 500.0f, 0.0f));
-    gib->scale(rand() % 100 / 100.0f * 0.5f);
-
-    // Creates random gib lifetime
-    auto lifetime = make_shared<float>(0.5f * (rand() % 4));
-    auto gibptr = gib.get();
 
-    // Connexts gib to game tick signal
-    gib->on_tick.connect([gibptr, lifetime](Freq::Time t){
-        *lifetime -= t.s();
-
-        if(*lifetime < 0.0f)
-            gibptr->detach();
-    });
+    // Sets gib position, size, movement and lifetime
+    m_pGame->gibs()->emit(
+        position(Space::WORLD) + vec3(rand() % 16 - 8.0f, rand() % 32 - 16.0f, 2.0f),
+        dir * 100.0f,
+        0.5f * (rand() % 4),
+        8.0f * (rand() % 100 / 100.0f * 0.5f)
+    );
 }
 
 
-void Monster :: sound(const std::string& fn) {
-    Sound::play(this, fn, m_pResources);
+void Monster :: sound(Mixer::Handle h) {
+    m_pGame->sound(h, this);
 }
 
 
@@ -440,14 +392,15 @@ void Monster :: cb_to_bullet(Node* monster_node, Node* bullet) {
         return;
 
     // bullet owner is a monster, ignore
-    if(bullet->config()->has("monster"))
+    auto b = (Bullet*)bullet;
+    if(b->monster())
         return;
 
-    if (monster->is_alive() and not bullet->detaching()) {
-        monster->sound("damage.wav");
+    if (monster->is_alive() and b->active()) {
+        monster->sound(monster->m_pGame->sounds().damage);
 
         auto hp_before = monster->m_HP;
-        monster->damage(bullet->config()->at("damage", 1));
+        monster->damage(b->damage());
         auto hp_after = monster->m_HP;
 
         if (hp_before > hp_after) {
@@ -465,14 +418,14 @@ void Monster :: cb_to_bullet(Node* monster_node, Node* bullet) {
             // Change direction based on bullet velocity
             if (bullet->velocity().x > K_EPSILON) {
                 monster->velocity(-abs(monster->velocity()));
-                monster->sprite()->set_state("left");
+                monster->state(monster->m_State.left);
             } else if (bullet->velocity().x < -K_EPSILON) {
                 monster->velocity(abs(monster->velocity()));
-                monster->sprite()->set_state("right");
+                monster->state(monster->m_State.right);
             }
             
-            // Schedule detachment and activate monster
-            bullet->safe_detach();
+            // Recycle the bullet and activate monster
+            monster->m_pGame->bullets()->release(bullet);
             //monster->activate();
         }
 
@@ -490,13 +443,34 @@ void Monster :: cb_to_static(Node* monster_node, Node* static_node) {
     if (not monster)
         return;
 
+    // walked into a wall, back off it and turn around
+    auto vel = monster->velocity();
+    if (not monster->m_Body.resolve().blocked_x)
+        return;
+    if (vel.x > 0.0f) {
+        monster->velocity(-abs(vel));
+        monster->state(monster->m_State.left);
+    } else {
+        monster->velocity(abs(vel));
+        monster->state(monster->m_State.right);
+    }
+}
+
+
+void Monster :: cb_to_fatal(Node* monster_node, Node* fatal_node) {
+    auto monster = monster_node->config()->at<Monster*>("monster",nullptr);
+
+    if (not monster)
+        return;
+
+    // spikes are not solid, monsters just turn away from them
     if (monster->num_snapshots()) {
-        if (static_node->world_box().center().x > monster->world_box().center().x) {
+        if (fatal_node->world_box().center().x > monster->world_box().center().x) {
             monster->velocity(-abs(monster->velocity()));
-            monster->sprite()->set_state("left");
-        } else if (static_node->world_box().center().x < monster->world_box().center().x) {
+            monster->state(monster->m_State.left);
+        } else if (fatal_node->world_box().center().x < monster->world_box().center().x) {
             monster->velocity(abs(monster->velocity()));
-            monster->sprite()->set_state("right");
+            monster->state(monster->m_State.right);
         }
     }
 }
@@ -5,10 +5,16 @@
 #include <memory>
 #include "Qor/TileMap.h" 
 #include "Qor/BasicPartitioner.h"
+#include "Colliders.h"
+#include "KinematicBody.h"
+#include "Mixer.h"
+#include "SpriteDef.h"
+#include "SpriteStates.h"
 
 class Player;
 class Game;
 class Sprite;
+class FireChain;
 
 class Monster: public Node {
     public:
@@ -22,6 +28,7 @@ class Monster: public Node {
             WIZARD,
         };
         static constexpr float DEFAULT_BULLET_SPEED = 256.0f;
+        static constexpr float ACTIVATION_RADIUS = 100.0f;
         static const int DEFAULT_STUN_TIME = 200;
 
         // Constructor
@@ -52,13 +59,15 @@ class Monster: public Node {
 
 
         // Getters
-        static unsigned get_type(const std::shared_ptr<Meta>& config);
+        static const std::vector<std::string>& type_names() { return s_TypeNames; }
         bool is_alive() const { return not m_Dead and not m_Dying; }
+        bool awake() const { return m_bAwake; }
         int hp() { return m_HP; }
         int max_hp() { return m_MaxHP; }
         Game* game() { return m_pGame; }
         Sprite* sprite() { return m_pSprite.get(); }
         MapTile* placeholder() { return m_pPlaceholder; }
+        const Colliders& colliders() const { return m_Colliders; }
 
 
         // Methods
@@ -69,17 +78,33 @@ class Monster: public Node {
         void shoot(float bullet_speed=DEFAULT_BULLET_SPEED, glm::vec3 offset = glm::vec3(0.0f), int life = 0);
         void stun(int m_StunTime);
         void gib();
-        void sound(const std::string& fn);
+
+        // sleeping monsters skip logic_self but for patrol(), Game decides
+        void sleep();
+        void wake();
+
+        // Game's activation bookkeeping
+        glm::ivec2& cell() { return m_Cell; }
+        unsigned wake_frame() const { return m_WakeFrame; }
+        void wake_frame(unsigned f) { m_WakeFrame = f; }
+        void sound(Mixer::Handle h);
 
 
         // Callbacks
         static void cb_to_bullet(Node* monster_node, Node* bullet);
         static void cb_to_static(Node* monster_node, Node* static_node);
+        static void cb_to_fatal(Node* monster_node, Node* fatal_node);
         static void cb_to_player(Node* player_node, Node* monster_node);
         static void cb_sensor_to_no_static(Node* sensor_node, Node* static_node);
 
     private:
         const static std::vector<std::string> s_TypeNames;
+
+        // activation and attacks, only while awake
+        void think(Freq::Time t);
+        // turning at ledges and keeping the hash cell current, the only
+        // step a sleeping monster runs
+        void patrol();
         
         unsigned m_MonsterID = 0;
         int m_HP = 1;
@@ -92,6 +117,9 @@ class Monster: public Node {
         bool m_Dead = false;
         bool m_Solid = false;
         bool m_bActive = false;
+        bool m_bAwake = true;
+        glm::ivec2 m_Cell;
+        unsigned m_WakeFrame = 0;
 
 
         std::string m_Identity; // String version of Type
@@ -107,8 +135,24 @@ class Monster: public Node {
         TileMap* m_pMap = nullptr;
         Freq::Timeline* m_pTimeline;
 
+        // shared with every monster of this type
+        std::shared_ptr<const SpriteDef> m_pDef;
+
+        // sets an animation state on the sprite, if it isn't already
+        void state(unsigned id) {
+            m_States.set(id);
+            m_States.apply(m_pSprite.get());
+        }
+        SpriteStates m_States;
+        struct {
+            unsigned left, right;
+            unsigned hit, unhit;
+        } m_State;
+
         // sprite is optional for thing type, not attached
         std::shared_ptr<Sprite> m_pSprite;
+        std::shared_ptr<FireChain> m_pFire; // wizards only
+        Colliders m_Colliders;
 
         // ground detection for monsters
         std::shared_ptr<Mesh> m_pLeft;
@@ -116,4 +160,5 @@ class Monster: public Node {
 
         Freq::Timeline m_LazyTimeline;
         Freq::Alarm m_ShootTimer;
+        KinematicBody m_Body;
 };
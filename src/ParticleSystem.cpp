@@ -0,0 +1,170 @@
+#include "ParticleSystem.h"
+#include <cstdlib>
+
+using namespace std;
+using namespace glm;
+
+
+ParticleSystem :: ParticleSystem(
+    const std::string& fn,
+    Cache<Resource, std::string>* resources,
+    unsigned frames,
+    glm::vec2 gravity,
+    unsigned capacity,
+    float fps
+):
+    m_Capacity(capacity),
+    m_Frames(std::max<unsigned>(frames, 1)),
+    m_Gravity(gravity),
+    m_FPS(fps)
+{
+    // center a unit quad, whatever origin the prefab uses
+    m_Quad = Prefab::quad(vec2(1.0f, 1.0f));
+    vec3 lo(m_Quad.at(0)), hi(m_Quad.at(0));
+    for (auto&& v: m_Quad) {
+        lo = glm::min(lo, v);
+        hi = glm::max(hi, v);
+    }
+    for (auto&& v: m_Quad)
+        v -= (lo + hi) / 2.0f;
+    m_QuadWrap = Prefab::quad_wrap(vec2(0.0f, 1.0f), vec2(1.0f, 0.0f));
+
+    m_pGeometry = make_shared<MeshGeometry>(vector<vec3>());
+    m_pWrap = make_shared<Wrap>(vector<vec2>());
+    m_pMesh = make_shared<Mesh>(
+        m_pGeometry,
+        vector<shared_ptr<IMeshModifier>>{ m_pWrap },
+        make_shared<MeshMaterial>(fn, resources)
+    );
+    m_pMesh->visible(false);
+    add(m_pMesh);
+
+    for (auto* v: { &m_X, &m_Y, &m_Z, &m_VX, &m_VY, &m_Life, &m_Age, &m_Size })
+        v->reserve(capacity);
+    m_Frame.reserve(capacity);
+}
+
+
+void ParticleSystem :: emit(glm::vec3 pos, glm::vec2 vel, float life, float size) {
+    if (life <= 0.0f || size <= 0.0f)
+        return;
+    if (m_Life.size() >= m_Capacity)
+        kill(0);
+
+    m_X.push_back(pos.x);
+    m_Y.push_back(pos.y);
+    m_Z.push_back(pos.z);
+    m_VX.push_back(vel.x);
+    m_VY.push_back(vel.y);
+    m_Life.push_back(life);
+    m_Age.push_back(0.0f);
+    m_Size.push_back(size);
+    // animated particles all start on the first frame
+    m_Frame.push_back(m_FPS > 0.0f ? 0 : rand() % m_Frames);
+}
+
+
+void ParticleSystem :: burst(glm::vec3 pos, unsigned count, float speed, float life, float size) {
+    for (unsigned i = 0; i < count; ++i) {
+        auto dir = Angle::degrees(1.0f * (rand() % 360)).vector();
+        emit(pos, dir * speed * (0.5f + (rand() % 50) / 100.0f), life, size);
+    }
+}
+
+
+void ParticleSystem :: clear() {
+    for (auto* v: { &m_X, &m_Y, &m_Z, &m_VX, &m_VY, &m_Life, &m_Age, &m_Size })
+        v->clear();
+    m_Frame.clear();
+    m_pMesh->visible(false);
+}
+
+
+void ParticleSystem :: kill(unsigned i) {
+    unsigned last = m_Life.size() - 1;
+    m_X[i] = m_X[last]; m_X.pop_back();
+    m_Y[i] = m_Y[last]; m_Y.pop_back();
+    m_Z[i] = m_Z[last]; m_Z.pop_back();
+    m_VX[i] = m_VX[last]; m_VX.pop_back();
+    m_VY[i] = m_VY[last]; m_VY.pop_back();
+    m_Life[i] = m_Life[last]; m_Life.pop_back();
+    m_Age[i] = m_Age[last]; m_Age.pop_back();
+    m_Size[i] = m_Size[last]; m_Size.pop_back();
+    m_Frame[i] = m_Frame[last]; m_Frame.pop_back();
+}
+
+
+void ParticleSystem :: logic_self(Freq::Time t) {
+    if (m_Life.empty())
+        return;
+
+    const float dt = t.s();
+    m_Step = dt;
+    const float gx = m_Gravity.x * dt;
+    const float gy = m_Gravity.y * dt;
+    const unsigned n = m_Life.size();
+
+    // plain loops over separate arrays so these vectorize
+    float* __restrict x = m_X.data();
+    float* __restrict y = m_Y.data();
+    float* __restrict vx = m_VX.data();
+    float* __restrict vy = m_VY.data();
+    float* __restrict life = m_Life.data();
+    float* __restrict age = m_Age.data();
+    for (unsigned i = 0; i < n; ++i) {
+        vx[i] += gx;
+        vy[i] += gy;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+        age[i] += dt;
+    }
+
+    for (unsigned i = 0; i < m_Life.size();) {
+        if (m_Life[i] <= 0.0f)
+            kill(i);
+        else
+            ++i;
+    }
+
+    rebuild();
+}
+
+
+void ParticleSystem :: blend(float t) {
+    if (not m_Life.empty())
+        rebuild((1.0f - t) * m_Step);
+}
+
+
+void ParticleSystem :: rebuild(float back) {
+    const unsigned n = m_Life.size();
+    const unsigned nv = m_Quad.size();
+
+    m_pMesh->visible(n > 0);
+    if (not n)
+        return;
+
+    auto& verts = m_pGeometry->verts();
+    auto& wrap = m_pWrap->data();
+    verts.resize(n * nv);
+    wrap.resize(n * nv);
+
+    vec3 lo(m_X[0], m_Y[0], m_Z[0]);
+    vec3 hi(lo);
+    const float fw = 1.0f / m_Frames;
+    for (unsigned i = 0; i < n; ++i) {
+        vec3 p(m_X[i] - m_VX[i] * back, m_Y[i] - m_VY[i] * back, m_Z[i]);
+        vec3 s(m_Size[i], m_Size[i], 1.0f);
+        unsigned frame = (m_Frame[i] + unsigned(m_Age[i] * m_FPS)) % m_Frames;
+        for (unsigned j = 0; j < nv; ++j) {
+            verts[i * nv + j] = p + m_Quad[j] * s;
+            wrap[i * nv + j] = vec2((frame + m_QuadWrap[j].x) * fw, m_QuadWrap[j].y);
+        }
+        lo = glm::min(lo, p - s);
+        hi = glm::max(hi, p + s);
+    }
+
+    m_pMesh->set_box(Box(lo, hi));
+    m_pMesh->clear_cache();
+}
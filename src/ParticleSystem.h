@@ -0,0 +1,73 @@
+#ifndef PARTICLESYSTEM_H_C0YH4K2N
+#define PARTICLESYSTEM_H_C0YH4K2N
+
+#include <memory>
+#include <vector>
+#include "Qor/Mesh.h"
+
+// Batched emitter for short lived effects (gibs, embers, flames, sparkles).
+// Particles are kept as parallel arrays and drawn through a single mesh,
+// so one emitter is one vertex buffer and one draw call.
+// Positions are in the space of the emitter's parent.
+class ParticleSystem: public Node {
+    public:
+        ParticleSystem(
+            const std::string& fn,
+            Cache<Resource, std::string>* resources,
+            unsigned frames = 1, // horizontal animation frames in the texture
+            glm::vec2 gravity = glm::vec2(0.0f),
+            unsigned capacity = 256,
+            float fps = 0.0f // 0 keeps each particle on a random frame
+        );
+        virtual ~ParticleSystem() {}
+
+        virtual void logic_self(Freq::Time t) override;
+
+        // replaces an existing particle when over capacity
+        void emit(glm::vec3 pos, glm::vec2 vel, float life, float size);
+
+        // count particles flying out in random directions
+        void burst(glm::vec3 pos, unsigned count, float speed, float life, float size);
+
+        // removes every particle
+        void clear();
+
+        // redraws the particles t of the way from the last step to the
+        // current one, for render blending
+        void blend(float t);
+
+        unsigned size() const { return m_Life.size(); }
+        std::shared_ptr<Mesh> mesh() { return m_pMesh; }
+
+    private:
+        void kill(unsigned i);
+        // back is how many seconds of motion to take back
+        void rebuild(float back = 0.0f);
+
+        unsigned m_Capacity;
+        unsigned m_Frames;
+        glm::vec2 m_Gravity;
+        float m_FPS;
+        float m_Step = 0.0f; // seconds, of the last logic_self
+
+        // particle state, one entry per live particle
+        std::vector<float> m_X;
+        std::vector<float> m_Y;
+        std::vector<float> m_Z;
+        std::vector<float> m_VX;
+        std::vector<float> m_VY;
+        std::vector<float> m_Life;
+        std::vector<float> m_Age;
+        std::vector<float> m_Size;
+        std::vector<unsigned> m_Frame;
+
+        // unit quad and its uvs, in Prefab vertex order
+        std::vector<glm::vec3> m_Quad;
+        std::vector<glm::vec2> m_QuadWrap;
+
+        std::shared_ptr<MeshGeometry> m_pGeometry;
+        std::shared_ptr<Wrap> m_pWrap;
+        std::shared_ptr<Mesh> m_pMesh;
+};
+
+#endif
@@ -4,6 +4,7 @@ using namespace std;
 using namespace glm;
 #include "Game.h"
 #include "Monster.h"
+#include "BulletPool.h"
 
 Player :: Player(
     std::string fn,
@@ -22,9 +23,19 @@ Player :: Player(
     m_pCamera(camera),
     m_pController(ctrl),
     m_pPartitioner(part),
-    m_pGame(game)
+    m_pGame(game),
+    m_Body(&game->collision_grids(), this)
 {
     set_states({"stand", "right", "forward"});
+    m_States.reset(game->sprite_def(fn));
+    m_States.init({"stand", "right", "forward"});
+    m_State = {
+        m_States.id("stand"), m_States.id("walk"),
+        m_States.id("jump"), m_States.id("walljump"),
+        m_States.id("left"), m_States.id("right"),
+        m_States.id("forward"), m_States.id("upward"),
+        m_States.id("up"), m_States.id("down"), m_States.id("downward")
+    };
     //m_pCamera->position(glm::vec3(-64.0f, -64.0f, 0.0f));
     position(glm::vec3(0.0f, 0.0f, 1.0f));
 
@@ -50,19 +61,16 @@ void Player :: enter() {
 
 
 void Player :: logic_self(Freq::Time t) {
+    PROFILE_ZONE("player logic");
     Sprite::logic_self(t);
 
-    auto feet_colliders = m_pGame->get_static_collisions(
-        Node::find("feetmask").at(0)
-    );
+    auto feet_colliders = m_pGame->get_static_collisions(feet_mask());
 
     //auto wall_colliders = m_pPartitioner->get_collisions_for(
-    //    Node::find("sidemask").at(0), STATIC
+    //    side_mask(), STATIC
     //);
 
-    auto wall_colliders = m_pGame->get_static_collisions(
-        Node::find("sidemask").at(0)
-    );
+    auto wall_colliders = m_pGame->get_static_collisions(side_mask());
 
     if (not feet_colliders.empty() && wall_colliders.empty()) {
         auto v = velocity();
@@ -74,28 +82,28 @@ void Player :: logic_self(Freq::Time t) {
     bool walljump = feet_colliders.empty() && not wall_colliders.empty();
 
     if (walljump)
-        set_state("walljump");
+        m_States.set(m_State.walljump);
     else if (in_air)
-        set_state("jump");
+        m_States.set(m_State.jump);
     
     glm::vec3 move(0.0f);
 
     if (velocity().x > -K_EPSILON && velocity().x < K_EPSILON) {
-        if (m_pController->button("left")) {
+        if (button("left")) {
             m_pCamera->track(focus_left());
             move += glm::vec3(-1.0f, 0.0f, 0.0f);
         }
-        if (m_pController->button("right")) {
+        if (button("right")) {
             m_pCamera->track(focus_right());
             move += glm::vec3(1.0f, 0.0f, 0.0f);
         }
     }
 
-    if (m_pController->button("shoot") && m_ShootTimer.elapsed())
+    if (button("shoot") && m_ShootTimer.elapsed())
         shoot();
         
     bool block_jump = false;
-    if (m_pController->button("jump")) {
+    if (button("jump")) {
         
         if (walljump || not in_air || not m_JumpTimer.elapsed()) {
             float x = 0.0f;
@@ -122,10 +130,8 @@ void Player :: logic_self(Freq::Time t) {
                     velocity(glm::vec3(x, -125.0f, 0.0f));
 
                     if (not in_air || walljump) {
-                        auto sounds = m_pCamera->find_type<Sound>();
-
-                        if(sounds.empty())
-                            Sound::play(m_pCamera, "jump.wav", m_pResources);
+                        // one voice only, a jump never cuts off another
+                        m_pGame->sound(m_pGame->sounds().jump, m_pCamera);
                         m_JumpTimer.set(Freq::Time::ms(200));
                     }
                 }
@@ -140,7 +146,7 @@ void Player :: logic_self(Freq::Time t) {
     }
 
     if (not in_air && m_WasInAir)
-        Sound::play(m_pCamera, "touch.wav", m_pResources);
+        m_pGame->sound(m_pGame->sounds().touch, m_pCamera);
 
     m_WasInAir = in_air;
     
@@ -149,15 +155,15 @@ void Player :: logic_self(Freq::Time t) {
 
     if (glm::length(move) > K_EPSILON) {
         if (not in_air)
-            set_state("walk");
+            m_States.set(m_State.walk);
 
         move = glm::normalize(move);
 
         if (move.x < -K_EPSILON){
-            set_state("left");
+            m_States.set(m_State.left);
         }
         else if (move.x > K_EPSILON){
-            set_state("right");
+            m_States.set(m_State.right);
         }
 
         move *= 100.0f * t.s();
@@ -167,44 +173,35 @@ void Player :: logic_self(Freq::Time t) {
     }
     else {
         if (not in_air)
-            set_state("stand");
+            m_States.set(m_State.stand);
 
         clear_snapshots();
         snapshot();
     }
 
-    if(m_pController->button("left") || m_pController->button("right")) {
-        if(m_pController->button("up"))
-            set_state("upward");
-        else if(m_pController->button("down"))
-            set_state("downward");
+    if(button("left") || button("right")) {
+        if(button("up"))
+            m_States.set(m_State.upward);
+        else if(button("down"))
+            m_States.set(m_State.downward);
         else
-            set_state("forward");
+            m_States.set(m_State.forward);
     }else{
-        if(m_pController->button("up"))
-            set_state("up");
-        else if(m_pController->button("down"))
-            set_state("down");
+        if(button("up"))
+            m_States.set(m_State.up);
+        else if(button("down"))
+            m_States.set(m_State.down);
         else
-            set_state("forward");
+            m_States.set(m_State.forward);
     }
+
+    m_States.apply(this);
 }
 
 
 void Player :: shoot() {
-    auto shot = make_shared<Mesh>(
-        make_shared<MeshGeometry>(Prefab::quad(glm::vec2(8.0f, 2.0f))),
-        vector<shared_ptr<IMeshModifier>>{
-            make_shared<Wrap>(Prefab::quad_wrap(
-                glm::vec2(0.0f, 1.0f), glm::vec2(1.0f, 0.0f)
-            ))
-        },
-        make_shared<MeshMaterial>("laser.png", m_pResources)
-    );
-    shot->config()->set<Player*>("player",this);
-
-    shot->material()->emissive(Color::white());
-    root()->add(shot);
+    auto shot = m_pGame->bullets()->spawn(BulletPool::PLAYER, 0.5f, root());
+    shot->owner(this);
 
     shot->position(glm::vec3(
         position().x +
@@ -217,11 +214,11 @@ void Player :: shoot() {
     ));
 
     vec3 aimdir = vec3(0.0f, 0.0f, 0.0f);
-    if(not check_state("up") && not check_state("down"))
-        aimdir += check_state("left") ? vec3(-1.0f, 0.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f);
-    if(check_state("up") || check_state("upward"))
+    if(not m_States.is(m_State.up) && not m_States.is(m_State.down))
+        aimdir += m_States.is(m_State.left) ? vec3(-1.0f, 0.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f);
+    if(m_States.is(m_State.up) || m_States.is(m_State.upward))
         aimdir += vec3(0.0f, -1.0f, 0.0f);
-    if(check_state("down") || check_state("downward"))
+    if(m_States.is(m_State.down) || m_States.is(m_State.downward))
         aimdir += vec3(0.0f, 1.0f, 0.0f);
     aimdir = normalize(aimdir);
     
@@ -229,23 +226,9 @@ void Player :: shoot() {
     shot->rotate(ang, glm::vec3(0.0f, 0.0f, 1.0f));
     shot->velocity(aimdir * 256.0f);
 
-    shot->when_with(Freq::Time::seconds(0.5f), m_pTimeline, [](Node* shot){
-        shot->detach();
-    });
-    
-    m_pPartitioner->register_object(shot, Game::BULLET);
-    
-    Sound::play(m_pCamera, "shoot.wav", m_pResources);
+    m_pGame->sound(m_pGame->sounds().shoot, m_pCamera);
 
     m_ShootTimer.set(Freq::Time::ms(m_Power == 0 ? 200 : 100));
-    
-    // increase box Z width
-    auto shotbox = shot->box();
-
-    shot->set_box(Box(
-        vec3(shotbox.min().x, shotbox.min().y, -5.0),
-        vec3(shotbox.max().x, shotbox.max().y, 5.0)
-    ));
 }
 
 void Player :: cb_to_bullet(Node* player_node, Node* bullet)
@@ -256,7 +239,8 @@ void Player :: cb_to_bullet(Node* player_node, Node* bullet)
         return;
 
     // bullet owner is a player, ignore
-    if(bullet->config()->has("player"))
+    auto b = (Bullet*)bullet;
+    if(not b->active() || b->player())
         return;
 
     player->reset();
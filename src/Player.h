@@ -4,6 +4,10 @@
 #include "Qor/Sprite.h"
 #include "Qor/Input.h"
 #include "Qor/Camera.h"
+#include "Colliders.h"
+#include "KinematicBody.h"
+#include "InputScript.h"
+#include "SpriteStates.h"
 
 class Game;
 
@@ -37,8 +41,29 @@ class Player: public Sprite {
         static void cb_to_bullet(Node* player_node, Node* bullet);
         
         void reset_walljump();
+
+        // masks created by Game::setup_player()
+        void colliders(const Colliders& c) {
+            m_Colliders = c;
+            m_Body.mask(c.body);
+        }
+        const Colliders& colliders() const { return m_Colliders; }
+        Node* body_mask() const { return m_Colliders.body; }
+        Node* feet_mask() const { return m_Colliders.feet; }
+        Node* side_mask() const { return m_Colliders.sides; }
+        // moves through the tiles with the body mask
+        KinematicBody& body() { return m_Body; }
+
+        // read buttons from a script instead of the controller
+        void input(const InputScript* script) { m_pScript = script; }
         
     private:
+
+        bool button(const std::string& name) const {
+            if (m_pScript)
+                return m_pScript->button(name);
+            return (bool)m_pController->button(name);
+        }
         
         Freq::Timeline* m_pTimeline;
         
@@ -55,9 +80,20 @@ class Player: public Sprite {
         unsigned m_Power = 0;
         
         Controller* m_pController;
+        const InputScript* m_pScript = nullptr;
+
+        // animation states, interned from guy.json once
+        SpriteStates m_States;
+        struct {
+            unsigned stand, walk, jump, walljump;
+            unsigned left, right;
+            unsigned forward, upward, up, down, downward;
+        } m_State;
         IPartitioner* m_pPartitioner;
+        Colliders m_Colliders;
 
         Game* m_pGame;
+        KinematicBody m_Body;
 };
 
 #endif
@@ -3,6 +3,8 @@
 #include "Qor/Input.h"
 #include "Qor/Material.h"
 #include "Qor/Qor.h"
+#include "Game.h"
+#include "LevelPreloader.h"
 #include <glm/glm.hpp>
 #include <cstdlib>
 #include <chrono>
@@ -64,6 +66,10 @@ void Pregame :: preload() {
     // TEMP: just for jam
     auto mapname = m_pQor->args().value("map");
     if(mapname != "3"){
+        // parse the level while this screen is up
+        if (not mapname.empty())
+            LevelPreloader::get().start(Game::preload_request(m_pQor, mapname));
+
         if(mapname == "1")
             mapname = "House";
         else if(mapname == "2")
@@ -0,0 +1,235 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <GL/glew.h>
+#include "kit/log/log.h"
+
+using namespace std;
+
+
+Profiler* Profiler :: s_pCurrent = nullptr;
+
+static vector<string>& zone_names() {
+    static vector<string> names;
+    return names;
+}
+
+
+unsigned Profiler :: zone(const char* name) {
+    auto& names = zone_names();
+    for (unsigned i = 0; i < names.size(); ++i)
+        if (names[i] == name)
+            return i;
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+
+Profiler :: Profiler(bool gpu):
+    m_Start(chrono::steady_clock::now()),
+    m_bGPU(gpu && GLEW_ARB_timer_query),
+    m_FrameID(zone("frame"))
+{
+    resize();
+    s_pCurrent = this;
+}
+
+
+Profiler :: ~Profiler() {
+    if (s_pCurrent == this)
+        s_pCurrent = nullptr;
+    if (m_bGPU) {
+        for (auto&& q: m_Pending)
+            m_FreeQueries.push_back(q.query);
+        if (not m_FreeQueries.empty())
+            glDeleteQueries(m_FreeQueries.size(), &m_FreeQueries[0]);
+    }
+}
+
+
+double Profiler :: now() const {
+    return chrono::duration<double, micro>(
+        chrono::steady_clock::now() - m_Start
+    ).count();
+}
+
+
+void Profiler :: resize() {
+    auto n = zone_names().size();
+    if (m_Frame.size() >= n)
+        return;
+    m_Frame.resize(n);
+    m_Average.resize(n);
+    m_Seen.resize(n, false);
+    m_Counted.resize(n, false);
+}
+
+
+void Profiler :: begin(unsigned id) {
+    if (id >= m_Frame.size())
+        resize();
+    m_Stack.push_back(Open{id, now()});
+}
+
+
+void Profiler :: end(unsigned id) {
+    if (m_Stack.empty())
+        return;
+    auto t = now();
+    auto open = m_Stack.back();
+    m_Stack.pop_back();
+
+    auto len = t - open.start;
+    m_Frame[id].cpu += len / 1000.0;
+    m_Frame[id].calls += 1.0f;
+    m_Seen[id] = true;
+    if (m_bCapture && m_Events.size() < MAX_EVENTS)
+        m_Events.push_back(Event{id, CPU, open.start, len});
+}
+
+
+void Profiler :: gpu_begin(unsigned id) {
+    if (not m_bGPU || m_bQueryOpen)
+        return;
+    if (id >= m_Frame.size())
+        resize();
+
+    GLuint q;
+    if (m_FreeQueries.empty())
+        glGenQueries(1, &q);
+    else {
+        q = m_FreeQueries.back();
+        m_FreeQueries.pop_back();
+    }
+    glBeginQuery(GL_TIME_ELAPSED, q);
+    m_Pending.push_back(Query{q, id, now()});
+    m_bQueryOpen = true;
+}
+
+
+void Profiler :: gpu_end() {
+    if (not m_bQueryOpen)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_bQueryOpen = false;
+}
+
+
+void Profiler :: poll() {
+    // results arrive in issue order, stop at the first one still in flight
+    unsigned done = 0;
+    for (; done < m_Pending.size(); ++done) {
+        auto& p = m_Pending[done];
+        if (m_bQueryOpen && done == m_Pending.size() - 1)
+            break;
+        GLint ready = 0;
+        glGetQueryObjectiv(p.query, GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (not ready)
+            break;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(p.query, GL_QUERY_RESULT, &ns);
+
+        // lands in the frame it was read back in, a frame or two late
+        m_Frame[p.id].gpu += ns / 1000000.0;
+        m_Seen[p.id] = true;
+        if (m_bCapture && m_Events.size() < MAX_EVENTS)
+            m_Events.push_back(Event{p.id, GPU, p.start, ns / 1000.0});
+        m_FreeQueries.push_back(p.query);
+    }
+    m_Pending.erase(m_Pending.begin(), m_Pending.begin() + done);
+}
+
+
+void Profiler :: frame() {
+    if (m_bGPU)
+        poll();
+
+    auto t = now();
+    m_Frame[m_FrameID].cpu += (t - m_FrameStart) / 1000.0;
+    m_Frame[m_FrameID].calls += 1.0f;
+    m_Seen[m_FrameID] = true;
+    if (m_bCapture && m_Frames && m_Events.size() < MAX_EVENTS)
+        m_Events.push_back(Event{m_FrameID, CPU, m_FrameStart, t - m_FrameStart});
+    if (m_bCapture && m_Events.size() >= MAX_EVENTS) {
+        WARNING("profiler capture full, later frames are not traced");
+        m_bCapture = false;
+    }
+
+    for (unsigned i = 0; i < m_Frame.size(); ++i) {
+        auto& f = m_Frame[i];
+        auto& a = m_Average[i];
+        // a zone's first frame seeds its average
+        if (m_Seen[i] && not m_Counted[i]) {
+            a = f;
+            m_Counted[i] = true;
+        }
+        else {
+            a.cpu += (f.cpu - a.cpu) * SMOOTHING;
+            a.gpu += (f.gpu - a.gpu) * SMOOTHING;
+            a.calls += (f.calls - a.calls) * SMOOTHING;
+        }
+        f = Totals();
+    }
+
+    m_FrameStart = t;
+    ++m_Frames;
+}
+
+
+vector<Profiler::Stat> Profiler :: stats() const {
+    auto& names = zone_names();
+    vector<Stat> r;
+    for (unsigned i = 0; i < m_Average.size(); ++i) {
+        if (not m_Seen[i])
+            continue;
+        auto& a = m_Average[i];
+        r.push_back(Stat{names[i], a.cpu, a.gpu, a.calls});
+    }
+    stable_sort(r.begin(), r.end(), [](const Stat& a, const Stat& b){
+        return std::max(a.cpu_ms, a.gpu_ms) > std::max(b.cpu_ms, b.gpu_ms);
+    });
+    return r;
+}
+
+
+string Profiler :: overlay(unsigned lines) const {
+    string r;
+    char buf[128];
+    auto s = stats();
+    if (s.size() > lines)
+        s.resize(lines);
+    for (auto&& st: s) {
+        if (m_bGPU && st.gpu_ms > 0.0f)
+            snprintf(buf, sizeof(buf), "%-14s %6.2f %6.2f gpu\n",
+                st.name.c_str(), st.cpu_ms, st.gpu_ms);
+        else
+            snprintf(buf, sizeof(buf), "%-14s %6.2f x%.0f\n",
+                st.name.c_str(), st.cpu_ms, st.calls);
+        r += buf;
+    }
+    return r;
+}
+
+
+void Profiler :: write_trace(const std::string& fn) const {
+    ofstream f(fn);
+    if (not f)
+        ERRORf(WRITE, "trace %s", fn);
+
+    auto& names = zone_names();
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << CPU
+      << ",\"args\":{\"name\":\"cpu\"}},\n";
+    f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPU
+      << ",\"args\":{\"name\":\"gpu\"}}";
+
+    char buf[64];
+    for (auto&& e: m_Events) {
+        f << ",\n{\"name\":\"" << names[e.id]
+          << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread;
+        snprintf(buf, sizeof(buf), ",\"ts\":%.3f,\"dur\":%.3f}", e.start, e.length);
+        f << buf;
+    }
+    f << "\n]}\n";
+}
@@ -0,0 +1,167 @@
+#ifndef PROFILER_H_6TQ2WZJM
+#define PROFILER_H_6TQ2WZJM
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Frame profiler.  PROFILE_ZONE("name") times the rest of the enclosing
+// scope on the CPU, gpu_begin()/gpu_end() time a render pass with GL timer
+// queries that are read back a few frames later instead of stalling.
+// Zones cost one branch while no profiler exists.  Per frame totals are
+// smoothed for the overlay, and while capturing every zone is also kept
+// as an event for a Chrome trace (chrome://tracing, ui.perfetto.dev).
+class Profiler {
+    public:
+        struct Stat {
+            std::string name;
+            float cpu_ms; // per frame, smoothed
+            float gpu_ms;
+            float calls;
+        };
+
+        Profiler(bool gpu);
+        ~Profiler();
+
+        // the live profiler, or nullptr
+        static Profiler* current() { return s_pCurrent; }
+        // stable id for a zone name, zones with the same name share it
+        static unsigned zone(const char* name);
+
+        void begin(unsigned id);
+        void end(unsigned id);
+        // one pass at a time, passes do not nest
+        void gpu_begin(unsigned id);
+        void gpu_end();
+        // closes the current frame and starts the next
+        void frame();
+
+        // keep every zone of every frame for write_trace()
+        void capture(bool b) { m_bCapture = b; }
+        bool capturing() const { return m_bCapture; }
+        size_t events() const { return m_Events.size(); }
+        unsigned frames() const { return m_Frames; }
+        bool gpu() const { return m_bGPU; }
+
+        // zones seen so far, most expensive first
+        std::vector<Stat> stats() const;
+        // stats() as a few lines of text, for the HUD
+        std::string overlay(unsigned lines = 12) const;
+        void write_trace(const std::string& fn) const;
+
+        class Scope {
+            public:
+                Scope(unsigned id):
+                    m_pProfiler(s_pCurrent),
+                    m_ID(id)
+                {
+                    if (m_pProfiler)
+                        m_pProfiler->begin(m_ID);
+                }
+                ~Scope() {
+                    if (m_pProfiler)
+                        m_pProfiler->end(m_ID);
+                }
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+            private:
+                Profiler* m_pProfiler;
+                unsigned m_ID;
+        };
+
+        // a Scope that is also timed on the GPU
+        class Pass {
+            public:
+                Pass(unsigned id):
+                    m_Scope(id),
+                    m_pProfiler(s_pCurrent)
+                {
+                    if (m_pProfiler)
+                        m_pProfiler->gpu_begin(id);
+                }
+                ~Pass() {
+                    if (m_pProfiler)
+                        m_pProfiler->gpu_end();
+                }
+                Pass(const Pass&) = delete;
+                Pass& operator=(const Pass&) = delete;
+            private:
+                Scope m_Scope;
+                Profiler* m_pProfiler;
+        };
+
+    private:
+        enum Thread {
+            CPU = 1,
+            GPU = 2
+        };
+        struct Event {
+            unsigned id;
+            unsigned thread;
+            double start; // microseconds since construction
+            double length;
+        };
+        struct Open {
+            unsigned id;
+            double start;
+        };
+        struct Query {
+            unsigned query;
+            unsigned id;
+            double start;
+        };
+        struct Totals {
+            float cpu = 0.0f;
+            float gpu = 0.0f;
+            float calls = 0.0f;
+        };
+
+        double now() const;
+        void resize();
+        void poll();
+
+        // exponential moving average weight of a new frame
+        static constexpr float SMOOTHING = 0.1f;
+        // captures stop here instead of eating memory
+        static constexpr size_t MAX_EVENTS = 1 << 21;
+
+        static Profiler* s_pCurrent;
+
+        std::chrono::steady_clock::time_point m_Start;
+        std::vector<Open> m_Stack;
+        std::vector<Totals> m_Frame; // by zone id
+        std::vector<Totals> m_Average;
+        std::vector<bool> m_Seen;
+        std::vector<bool> m_Counted; // has an average
+        std::vector<Event> m_Events;
+        double m_FrameStart = 0.0;
+        unsigned m_Frames = 0;
+        bool m_bCapture = false;
+
+        bool m_bGPU = false;
+        unsigned m_FrameID; // the frame itself is a zone too
+        bool m_bQueryOpen = false;
+        std::vector<unsigned> m_FreeQueries;
+        std::vector<Query> m_Pending; // in issue order
+};
+
+#define PROFILE_CAT_(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT_(a, b)
+
+// times the rest of the enclosing scope as zone NAME
+#define PROFILE_ZONE(NAME) \
+    static const unsigned PROFILE_CAT(_profile_id_, __LINE__) = \
+        Profiler::zone(NAME); \
+    Profiler::Scope PROFILE_CAT(_profile_scope_, __LINE__)( \
+        PROFILE_CAT(_profile_id_, __LINE__) \
+    )
+
+// PROFILE_ZONE for a render pass, with a GL timer query around it
+#define PROFILE_PASS(NAME) \
+    static const unsigned PROFILE_CAT(_profile_id_, __LINE__) = \
+        Profiler::zone(NAME); \
+    Profiler::Pass PROFILE_CAT(_profile_pass_, __LINE__)( \
+        PROFILE_CAT(_profile_id_, __LINE__) \
+    )
+
+#endif
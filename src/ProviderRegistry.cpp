@@ -0,0 +1,29 @@
+#include "ProviderRegistry.h"
+#include "Profiler.h"
+
+using namespace std;
+
+
+ProviderRegistry :: ProviderRegistry(BasicPartitioner* partitioner):
+    m_pPartitioner(partitioner)
+{}
+
+
+bool ProviderRegistry :: add(TileLayer* layer, unsigned type, Provider provider) {
+    if (not m_Registered.insert(make_pair(layer, type)).second)
+        return false;
+
+    auto _this = this;
+    m_pPartitioner->register_provider(type, [_this, provider](Box box){
+        PROFILE_ZONE("providers");
+        ++_this->m_Calls;
+        return provider(box);
+    });
+
+    return true;
+}
+
+
+bool ProviderRegistry :: has(TileLayer* layer, unsigned type) const {
+    return m_Registered.find(make_pair(layer, type)) != m_Registered.end();
+}
@@ -0,0 +1,35 @@
+#ifndef PROVIDERREGISTRY_H_R3QX7TLA
+#define PROVIDERREGISTRY_H_R3QX7TLA
+
+#include <memory>
+#include <set>
+#include <utility>
+#include "Qor/TileMap.h"
+#include "Qor/BasicPartitioner.h"
+
+// Keeps track of which (layer, object type) pairs already have a collision
+// provider so that each layer is queried once per type, no matter how many
+// tiles in it are collidable.
+class ProviderRegistry {
+    public:
+        typedef std::function<std::vector<std::weak_ptr<Node>>(Box)> Provider;
+
+        ProviderRegistry(BasicPartitioner* partitioner);
+        ~ProviderRegistry() {}
+
+        // returns false if this layer already provides this type
+        bool add(TileLayer* layer, unsigned type, Provider provider);
+        bool has(TileLayer* layer, unsigned type) const;
+        size_t size() const { return m_Registered.size(); }
+
+        // number of provider invocations since the last reset
+        unsigned calls() const { return m_Calls; }
+        void reset_calls() { m_Calls = 0; }
+
+    private:
+        BasicPartitioner* m_pPartitioner = nullptr;
+        std::set<std::pair<TileLayer*, unsigned>> m_Registered;
+        unsigned m_Calls = 0;
+};
+
+#endif
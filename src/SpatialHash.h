@@ -0,0 +1,92 @@
+#ifndef SPATIALHASH_H_FO8Y2MWQ
+#define SPATIALHASH_H_FO8Y2MWQ
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Uniform grid of buckets keyed by cell, for "what is near this point"
+// queries that only look at the handful of cells a radius touches.
+template<class T>
+class SpatialHash {
+    public:
+        SpatialHash(float cell_size):
+            m_CellSize(cell_size)
+        {}
+
+        float cell_size() const { return m_CellSize; }
+
+        glm::ivec2 cell(glm::vec2 pos) const {
+            return glm::ivec2(
+                (int)std::floor(pos.x / m_CellSize),
+                (int)std::floor(pos.y / m_CellSize)
+            );
+        }
+
+        void insert(T v, glm::ivec2 c) {
+            m_Cells[key(c)].push_back(v);
+        }
+
+        void remove(T v, glm::ivec2 c) {
+            auto itr = m_Cells.find(key(c));
+            if (itr == m_Cells.end())
+                return;
+            auto& b = itr->second;
+            auto vitr = std::find(b.begin(), b.end(), v);
+            if (vitr != b.end()) {
+                *vitr = b.back();
+                b.pop_back();
+            }
+        }
+
+        // moves v if pos is outside cell c, returns true if it moved
+        bool update(T v, glm::ivec2& c, glm::vec2 pos) {
+            auto nc = cell(pos);
+            if (nc == c)
+                return false;
+            remove(v, c);
+            insert(v, nc);
+            c = nc;
+            return true;
+        }
+
+        // empties every bucket but keeps their storage
+        void clear() {
+            for (auto&& b: m_Cells)
+                b.second.clear();
+        }
+
+        // calls func(T) for everything in the cells touched by the circle
+        template<class Func>
+        void each_near(glm::vec2 pos, float radius, Func func) const {
+            each_in(pos - glm::vec2(radius), pos + glm::vec2(radius), func);
+        }
+
+        // calls func(T) for everything in the cells touched by the rect
+        template<class Func>
+        void each_in(glm::vec2 min, glm::vec2 max, Func func) const {
+            auto lo = cell(min);
+            auto hi = cell(max);
+            for (int y = lo.y; y <= hi.y; ++y)
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    auto itr = m_Cells.find(key(glm::ivec2(x, y)));
+                    if (itr == m_Cells.end())
+                        continue;
+                    for (auto&& v: itr->second)
+                        func(v);
+                }
+        }
+
+    private:
+        static uint64_t key(glm::ivec2 c) {
+            return (uint64_t(uint32_t(c.x)) << 32) | uint32_t(c.y);
+        }
+
+        float m_CellSize;
+        std::unordered_map<uint64_t, std::vector<T>> m_Cells;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#include "SpriteDef.h"
+#include <algorithm>
+#include <fstream>
+#include <json/json.h>
+#include "kit/log/log.h"
+
+using namespace std;
+using namespace glm;
+
+const unsigned SpriteDef :: NO_STATE;
+
+
+namespace {
+    vec2 read_vec2(const Json::Value& v, vec2 def) {
+        if (not v.isArray() || v.size() < 2)
+            return def;
+        return vec2(v[0].asFloat(), v[1].asFloat());
+    }
+
+    void read_frames(
+        const Json::Value& v,
+        const string& state,
+        vector<SpriteDef::Animation>& out
+    ){
+        if (v.isObject()) {
+            for (auto&& key: v.getMemberNames())
+                read_frames(v[key], state.empty() ? key : state + "." + key, out);
+            return;
+        }
+        if (not v.isArray())
+            return;
+
+        SpriteDef::Animation a;
+        a.state = state;
+        for (auto&& f: v) {
+            if (f.isString()) {
+                auto s = f.asString();
+                if (s == "hflip")
+                    a.hflip = true;
+                else if (s == "vflip")
+                    a.vflip = true;
+            } else if (f.isNumeric())
+                a.frames.push_back(f.asUInt());
+        }
+        out.push_back(std::move(a));
+    }
+}
+
+
+std::shared_ptr<SpriteDef> SpriteDef :: load(const std::string& fn) {
+    ifstream f(fn);
+    if (not f)
+        ERRORf(READ, "sprite %s", fn);
+
+    Json::Value root;
+    Json::Reader reader;
+    if (not reader.parse(f, root) || not root.isObject())
+        ERRORf(PARSE, "sprite %s", fn);
+
+    auto def = make_shared<SpriteDef>();
+    def->path = fn;
+    def->config = make_shared<Meta>(fn);
+    def->size = read_vec2(root["size"], vec2(0.0f));
+    def->tile_size = read_vec2(root["tile-size"], def->size);
+    def->origin = read_vec2(root["origin"], vec2(0.0f));
+
+    auto& mask = root["mask"];
+    if (mask.isArray() && mask.size() == 4)
+        def->mask = Box(
+            vec3(mask[0].asFloat(), mask[1].asFloat(), -0.5f),
+            vec3(mask[2].asFloat(), mask[3].asFloat(), 0.5f)
+        );
+    else
+        def->mask = Box(vec3(0.0f, 0.0f, -0.5f), vec3(1.0f, 1.0f, 0.5f));
+
+    def->hp = root.get("hp", def->hp).asInt();
+    def->speed = root.get("speed", def->speed).asFloat();
+
+    auto& anim = root["animation"];
+    if (anim.isObject()) {
+        def->animation_speed = anim.get("speed", def->animation_speed).asFloat();
+        read_frames(anim["frames"], "", def->animations);
+        std::sort(ENTIRE(def->animations), [](const Animation& a, const Animation& b){
+            return a.state < b.state;
+        });
+    }
+    def->compile();
+    return def;
+}
+
+
+void SpriteDef :: compile() {
+    vector<vector<unsigned>> paths;
+    for (auto&& a: animations) {
+        vector<unsigned> path;
+        size_t start = 0;
+        for (unsigned level = 0; start <= a.state.size(); ++level) {
+            auto end = a.state.find('.', start);
+            if (end == string::npos)
+                end = a.state.size();
+            auto name = a.state.substr(start, end - start);
+            start = end + 1;
+
+            if (level >= category_sizes.size())
+                category_sizes.push_back(0);
+
+            // names are assumed unique across categories, first one wins
+            auto id = state(name);
+            if (id == NO_STATE) {
+                id = states.size();
+                states.push_back(State{name, level, category_sizes[level]++});
+            }
+            path.push_back(id);
+        }
+        paths.push_back(path);
+    }
+
+    // dense table only when every path names one state per category
+    size_t size = 1;
+    for (auto&& n: category_sizes)
+        size *= n;
+    for (auto&& p: paths)
+        if (p.size() != category_sizes.size())
+            return;
+    combos.assign(size, -1);
+    for (unsigned i = 0; i < paths.size(); ++i)
+        combos[combo(paths[i].data())] = i;
+}
+
+
+unsigned SpriteDef :: combo(const unsigned* current) const {
+    unsigned r = 0;
+    for (unsigned c = 0; c < category_sizes.size(); ++c)
+        r = r * category_sizes[c] + states[current[c]].index;
+    return r;
+}
+
+
+unsigned SpriteDef :: state(const std::string& name) const {
+    for (unsigned i = 0; i < states.size(); ++i)
+        if (states[i].name == name)
+            return i;
+    return NO_STATE;
+}
+
+
+const SpriteDef::Animation* SpriteDef :: animation(const unsigned* current) const {
+    if (combos.empty())
+        return nullptr;
+    for (unsigned c = 0; c < category_sizes.size(); ++c)
+        if (current[c] == NO_STATE)
+            return nullptr;
+    int i = combos[combo(current)];
+    return i < 0 ? nullptr : &animations[i];
+}
+
+
+const SpriteDef::Animation* SpriteDef :: animation(const std::string& state) const {
+    auto itr = std::lower_bound(ENTIRE(animations), state, [](const Animation& a, const string& s){
+        return a.state < s;
+    });
+    if (itr == animations.end() || itr->state != state)
+        return nullptr;
+    return &*itr;
+}
+
+
+std::shared_ptr<const SpriteDef> SpriteDefCache :: get(const std::string& fn) {
+    auto itr = m_Defs.find(fn);
+    if (itr != m_Defs.end()) {
+        ++m_Hits;
+        return itr->second;
+    }
+
+    ++m_Misses;
+    shared_ptr<const SpriteDef> def;
+    try {
+        def = SpriteDef::load(fn);
+    } catch(const std::exception& e) {
+        WARNING(e.what());
+        return nullptr;
+    }
+    m_Defs[fn] = def;
+    return def;
+}
+
+
+void SpriteDefCache :: add(const std::shared_ptr<const SpriteDef>& def) {
+    if (def)
+        m_Defs[def->path] = def;
+}
@@ -0,0 +1,83 @@
+#ifndef SPRITEDEF_H_C8RWX4LN
+#define SPRITEDEF_H_C8RWX4LN
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Qor/Node.h"
+
+// Parsed sprite json (animation frame tables, mask, size, stats), loaded
+// once per file and shared by every instance. Never modified after load.
+struct SpriteDef {
+    struct Animation {
+        std::string state; // frame table path, like "forward.left.walk"
+        std::vector<unsigned> frames;
+        bool hflip = false;
+        bool vflip = false;
+    };
+
+    // parses fn, safe to call from any thread
+    static std::shared_ptr<SpriteDef> load(const std::string& fn);
+
+    // animation for a state path, or nullptr
+    const Animation* animation(const std::string& state) const;
+
+    // Every name in the frame table is interned to a state id at load.
+    // Level i of a state path is category i (aim, facing, action...), and
+    // each combination of one state per category indexes the combo table.
+    static const unsigned NO_STATE = ~0u;
+
+    unsigned state(const std::string& name) const;
+    unsigned category(unsigned id) const { return states[id].category; }
+    unsigned categories() const { return category_sizes.size(); }
+    // current holds one state id per category
+    const Animation* animation(const unsigned* current) const;
+
+    std::string path;
+    std::shared_ptr<Meta> config; // the same json, for merging into configs
+    glm::vec2 size = glm::vec2(0.0f);
+    glm::vec2 tile_size = glm::vec2(0.0f);
+    glm::vec2 origin = glm::vec2(0.0f);
+    Box mask; // sprite units, z spans -0.5 to 0.5
+    int hp = 5;
+    float speed = 10.0f;
+    float animation_speed = 10.0f;
+    std::vector<Animation> animations; // sorted by state
+
+    struct State {
+        std::string name;
+        unsigned category;
+        unsigned index; // within category
+    };
+    std::vector<State> states; // by id
+    std::vector<unsigned> category_sizes;
+    std::vector<int> combos; // animation index, -1 if none
+
+    private:
+        void compile();
+        unsigned combo(const unsigned* current) const;
+};
+
+class SpriteDefCache {
+    public:
+        SpriteDefCache() {}
+        ~SpriteDefCache() {}
+
+        // loads on a miss, returns nullptr if the file can't be parsed
+        std::shared_ptr<const SpriteDef> get(const std::string& fn);
+        // adds a def loaded elsewhere (like LevelPreloader)
+        void add(const std::shared_ptr<const SpriteDef>& def);
+
+        unsigned hits() const { return m_Hits; }
+        unsigned misses() const { return m_Misses; }
+        size_t size() const { return m_Defs.size(); }
+
+    private:
+        std::map<std::string, std::shared_ptr<const SpriteDef>> m_Defs;
+        unsigned m_Hits = 0;
+        unsigned m_Misses = 0;
+};
+
+#endif
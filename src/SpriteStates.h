@@ -0,0 +1,68 @@
+#ifndef SPRITESTATES_H_9PVQ2TZE
+#define SPRITESTATES_H_9PVQ2TZE
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Qor/Sprite.h"
+#include "SpriteDef.h"
+
+// Current animation state of one sprite as interned ids, one per category.
+// Hot code sets and tests ids; the Qor sprite is only told by name, once
+// per category that actually changed, on apply().
+class SpriteStates {
+    public:
+        SpriteStates() {}
+        SpriteStates(const std::shared_ptr<const SpriteDef>& def) { reset(def); }
+
+        void reset(const std::shared_ptr<const SpriteDef>& def) {
+            m_pDef = def;
+            m_Current.assign(def ? def->categories() : 0, SpriteDef::NO_STATE);
+            m_Dirty = 0;
+        }
+
+        // resolve once, at setup
+        unsigned id(const std::string& name) const {
+            return m_pDef ? m_pDef->state(name) : SpriteDef::NO_STATE;
+        }
+
+        // states the sprite already has, see Sprite::set_states()
+        void init(const std::vector<std::string>& names) {
+            for (auto&& n: names)
+                set(id(n));
+            m_Dirty = 0;
+        }
+
+        void set(unsigned id) {
+            if (id == SpriteDef::NO_STATE)
+                return;
+            unsigned c = m_pDef->category(id);
+            if (m_Current[c] != id) {
+                m_Current[c] = id;
+                m_Dirty |= 1u << c;
+            }
+        }
+        bool is(unsigned id) const {
+            return id != SpriteDef::NO_STATE &&
+                m_Current[m_pDef->category(id)] == id;
+        }
+
+        // frames of the current combination
+        const SpriteDef::Animation* animation() const {
+            return m_pDef ? m_pDef->animation(m_Current.data()) : nullptr;
+        }
+
+        bool dirty() const { return m_Dirty; }
+        void apply(Sprite* sprite) {
+            for (unsigned c = 0; m_Dirty; ++c, m_Dirty >>= 1)
+                if (m_Dirty & 1)
+                    sprite->set_state(m_pDef->states[m_Current[c]].name);
+        }
+
+    private:
+        std::shared_ptr<const SpriteDef> m_pDef;
+        std::vector<unsigned> m_Current;
+        unsigned m_Dirty = 0;
+};
+
+#endif
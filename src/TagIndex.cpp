@@ -0,0 +1,28 @@
+#include "TagIndex.h"
+
+using namespace std;
+
+
+void TagIndex :: add(const std::string& name, const std::string& type, MapTile* tile) {
+    if (name.empty())
+        return;
+    m_Tags[name].push_back(tile);
+    if (not type.empty())
+        m_Tags[key(name, type)].push_back(tile);
+}
+
+
+const std::vector<MapTile*>& TagIndex :: find(const std::string& name) const {
+    static const vector<MapTile*> none;
+    auto itr = m_Tags.find(name);
+    return itr == m_Tags.end() ? none : itr->second;
+}
+
+
+const std::vector<MapTile*>& TagIndex :: find(
+    const std::string& name, const std::string& type
+) const {
+    if (type.empty())
+        return find(name);
+    return find(key(name, type));
+}
@@ -0,0 +1,34 @@
+#ifndef TAGINDEX_H_Q5VDN3KE
+#define TAGINDEX_H_Q5VDN3KE
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Qor/TileMap.h"
+
+// Entity placeholder tiles by name and by name and type ("door", "red"),
+// built once at load so gameplay lookups never walk a layer's tiles.
+class TagIndex {
+    public:
+        TagIndex() {}
+        ~TagIndex() {}
+
+        void add(const std::string& name, const std::string& type, MapTile* tile);
+        void clear() { m_Tags.clear(); }
+
+        // every tile named name, or only those of the given type
+        const std::vector<MapTile*>& find(const std::string& name) const;
+        const std::vector<MapTile*>& find(
+            const std::string& name, const std::string& type
+        ) const;
+        size_t count(const std::string& name) const { return find(name).size(); }
+
+    private:
+        static std::string key(const std::string& name, const std::string& type) {
+            return name + ":" + type;
+        }
+
+        std::unordered_map<std::string, std::vector<MapTile*>> m_Tags;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "Thing.h"
 #include "Game.h"
 #include "Player.h"
+#include "ParticleSystem.h"
 #include "Qor/Sprite.h"
 
 using namespace std;
@@ -40,9 +41,10 @@ Thing :: Thing( // Parameters
     m_pMap(map),
     m_pResources(resources),
     m_Identity(config->at<string>("name", "")),
-    m_ThingID(get_id(config)),
+    m_ThingID(game->entities().type(config).id),
     m_StunTimer(timeline),
-    m_pTimeline(timeline)
+    m_pTimeline(timeline),
+    m_Body(&game->collision_grids(), this)
 {}
 
 
@@ -64,58 +66,35 @@ void Thing :: initialize() {
 
     m_Box = m_pPlaceholder->box();
 
+    // the thing is its own mask
+    m_Colliders.body = this;
+    m_Body.mask(m_Colliders.body);
     m_pPartitioner->register_object(shared_from_this(), Game::THING);
     
+    // items never move until picked up, so their glow is baked
     const float item_dist = 200.0f;
     const float glow = 1.0f;
+    auto pos = m_pPlaceholder->world_box().center();
 
     if (m_ThingID == Thing::STAR) {
         //m_pPlaceholder->visible(false);
-    
-        auto l = make_shared<Light>();
-        string type = config()->at<string>("type");
-
-        l->ambient(Color::white() * glow);
-        l->diffuse(Color::white() * glow);
-        l->specular(Color::white() * glow);
-        l->dist(item_dist);
-        l->move(glm::vec3(glm::vec3(0.5f, 0.5f, 0.0f)));
-        add(l);
+        m_Light = m_pGame->add_light(pos, vec3(1.0f) * glow, item_dist);
         collapse();
 
     }
     else if (m_ThingID == Thing::BATTERY) {
-        auto l = make_shared<Light>();
-        l->ambient(Color::green() * glow);
-        l->diffuse(Color::green() * glow);
-        l->specular(Color::white() * glow);
-        l->dist(item_dist);
-        l->move(glm::vec3(glm::vec3(0.5f, 0.5f, 0.0f)));
-        add(l);
+        m_Light = m_pGame->add_light(pos, vec3(0.0f, 1.0f, 0.0f) * glow, item_dist);
         collapse();
 
     }
     else if (m_ThingID == Thing::HEART) {
-        auto l = make_shared<Light>();
-        l->ambient(Color::red() * glow);
-        l->diffuse(Color::red() * glow);
-        l->specular(Color::white() * glow);
-        l->dist(item_dist);
-        l->move(glm::vec3(glm::vec3(0.5f, 0.5f, 0.0f)));
-        add(l);
+        m_Light = m_pGame->add_light(pos, vec3(1.0f, 0.0f, 0.0f) * glow, item_dist);
         collapse();
 
     } else if (m_ThingID == Thing::KEY) {
-        auto l = make_shared<Light>();
         string typ = config()->at<string>("type");
-        auto col = typ == "red" ? Color::red() : Color::blue();
-
-        l->ambient(col * glow);
-        l->diffuse(col * glow);
-        l->specular(Color::white() * glow);
-        l->dist(item_dist);
-        l->move(glm::vec3(glm::vec3(0.5f, 0.5f, 0.0f)));
-        add(l);
+        auto col = typ == "red" ? vec3(1.0f, 0.0f, 0.0f) : vec3(0.0f, 0.0f, 1.0f);
+        m_Light = m_pGame->add_light(pos, col * glow, item_dist);
         collapse();
     } else if (m_ThingID == Thing::DOOR) {
         m_Solid = true;
@@ -123,8 +102,14 @@ void Thing :: initialize() {
 }
 
 
-void Thing :: sound(const std::string& fn) {
-    Sound::play(this, fn, m_pResources);
+void Thing :: sound(Mixer::Handle h) {
+    m_pGame->sound(h, this);
+}
+
+
+void Thing :: sparkle() {
+    auto pos = m_pPlaceholder->world_box().center();
+    m_pGame->sparkles()->burst(vec3(pos.x, pos.y, pos.z + 1.0f), 8, 60.0f, 0.4f, 4.0f);
 }
 
 
@@ -133,20 +118,6 @@ void Thing :: setup_map(const std::shared_ptr<TileMap>& map) {}
 void Thing :: setup_other(const std::shared_ptr<Thing>& thing) {}
 
 
-unsigned Thing :: get_id(const std::shared_ptr<Meta>& config) {
-    string name = config->at<string>("name", "");
-    
-    if (name.empty())
-        return INVALID_THING;
-
-    auto itr = std::find(ENTIRE(s_TypeNames),name);
-    if (itr == s_TypeNames.end())
-        return INVALID_THING;
-    
-    return std::distance(s_TypeNames.begin(), itr);
-}
-
-
 void Thing :: cb_to_player(Node* player_node, Node* thing_node) {
     auto thing = (Thing*) thing_node;
 
@@ -157,29 +128,23 @@ void Thing :: cb_to_player(Node* player_node, Node* thing_node) {
             thing->m_pPlaceholder->visible(false);
             thing->add(thing->placeholder()->mesh()->instance());
             
-            thing->sound("pickup2.wav");
+            thing->sound(thing->m_pGame->sounds().pickup2);
+            thing->sparkle();
 
             thing->m_Collidable = false;
 
             // Move Spirally prepwork
-            auto timer = make_shared<Freq::Alarm>(thing->timeline());
-            timer->set(Freq::Time::seconds(0.75f));
-
             auto n = make_shared<Node>();
             thing->parent()->add(n);
             n->position(thing->position());
             thing->position(vec3(0.0f));
             n->add(thing->as_node());
 
-            auto thingptr = thing;
-            thing->on_tick.connect([timer, thingptr](Freq::Time t){
-                thingptr->parent()->rotate(t.s(), glm::vec3(0.0f, 0.0f, 1.0f));
-                thingptr->velocity(glm::vec3(150.0f, 0.0f, 0.0f));
-
-                if (timer->elapsed()){
-                    thingptr->visible(false);
-                    thingptr->parent()->safe_detach();
-                }
+            thing->m_pGame->enable_light(thing->m_Light, false);
+            thing->m_Spinning = true;
+            thing->velocity(glm::vec3(150.0f, 0.0f, 0.0f));
+            thing->m_pGame->after(0.75f, Game::Timer{
+                Game::Timer::COLLECT, thing->as_node()
             });
             
             //thing->m_ResetCon = thing->game()->on_reset.connect([thing]{
@@ -194,30 +159,35 @@ void Thing :: cb_to_player(Node* player_node, Node* thing_node) {
         }
     } else if (thing->id() == Thing::HEART) {
         if (thing->placeholder()->visible()) {
-            thing->sound("pickup.wav");
+            thing->sound(thing->m_pGame->sounds().pickup);
+            thing->sparkle();
             thing->visible(false);
             thing->placeholder()->visible(false);
+            thing->m_pGame->enable_light(thing->m_Light, false);
 
             thing->m_ResetCon = thing->game()->on_reset.connect([thing]{
                 thing->visible(true);
                 thing->placeholder()->visible(true);
+                thing->m_pGame->enable_light(thing->m_Light, true);
             });
         }
     } else if(thing->id() == Thing::BATTERY) {
         if (thing->placeholder()->visible()) {
-            thing->sound("pickup.wav");
+            thing->sound(thing->m_pGame->sounds().pickup);
+            thing->sparkle();
             thing->visible(false);
             thing->placeholder()->visible(false);
+            thing->m_pGame->enable_light(thing->m_Light, false);
 
             thing->m_ResetCon = thing->game()->on_reset.connect([thing]{
                 thing->visible(true);
                 thing->placeholder()->visible(true);
+                thing->m_pGame->enable_light(thing->m_Light, true);
             });
             player_node->parent()->event("battery");
         }
     } else if (thing->id() == Thing::SPRING) {
-        if (thing->find_type<Sound>().empty())
-            thing->sound("spring.wav");
+        thing->sound(thing->m_pGame->sounds().spring);
 
         //auto player = player_node->parent();// mask -> mesh -> sprite
         auto player = player_node->config()->at<Player*>("player");
@@ -231,26 +201,17 @@ void Thing :: cb_to_player(Node* player_node, Node* thing_node) {
         
     } else if (thing->id() == Thing::KEY) {
         if (thing->placeholder()->visible()) {
-            thing->sound("pickup.wav");
+            thing->sound(thing->m_pGame->sounds().pickup);
+            thing->sparkle();
             thing->placeholder()->visible(false);
+            thing->m_pGame->enable_light(thing->m_Light, false);
 
             auto layer = thing->m_pPlaceholder->tile_layer();
             auto keycol = thing->config()->at<string>("type");
 
-            for (auto&& tile: thing->m_pPlaceholder->tile_layer()->tiles()) {
-                if (not tile)
-                    continue;
-
-                for (auto&& ch: *tile) {
-                    if (ch->name() == "door") {
-                        auto col = ch->config()->at<string>("type","");
-
-                        if (col == keycol) {
-                            ch->parent()->visible(false);
-                        }
-                    }
-                }
-            }
+            for (auto&& door: thing->m_pGame->tags().find("door", keycol))
+                if (door->tile_layer() == layer)
+                    door->visible(false);
         }
     } else if (thing->id() == Thing::DOOR) {
         if (thing->placeholder()->visible()) {
@@ -265,10 +226,13 @@ void Thing :: cb_to_player(Node* player_node, Node* thing_node) {
 
 
 void Thing :: cb_to_static(Node* thing_node, Node* static_node) {
-    auto thing = thing_node->config()->at<Thing*>("thing",nullptr);
+    auto thing = (Thing*) thing_node;
 
-    if (not thing)
+    // a collected star moves in the space of its turning parent, which
+    // the body can't resolve, and it is gone within the second anyway
+    if (thing->m_Spinning)
         return;
+    thing->m_Body.resolve();
 }
 
 
@@ -280,6 +244,26 @@ void Thing :: cb_to_bullet(Node* thing_node, Node* bullet) {
 }
 
 
-//void Thing :: logic_self(Freq::Time t) {}
+void Thing :: logic_self(Freq::Time t) {
+    if (not m_bAwake)
+        return;
+
+    if (m_Spinning)
+        parent()->rotate(t.s(), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    // only thrown things move, the body sweeps from here
+    clear_snapshots();
+    if (glm::length(velocity()) > K_EPSILON)
+        snapshot();
+}
+
+
+void Thing :: collected() {
+    m_Spinning = false;
+    visible(false);
+    parent()->safe_detach();
+}
+
+
 //void Thing :: lazy_logic_self(Freq::Time t) {}
 
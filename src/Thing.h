@@ -4,6 +4,9 @@
 #include <memory>
 #include "Qor/TileMap.h" 
 #include "Qor/BasicPartitioner.h"
+#include "Colliders.h"
+#include "KinematicBody.h"
+#include "Mixer.h"
 
 
 class Game;
@@ -50,14 +53,14 @@ class Thing: public Node {
 
         
         // Static Methods
-        static unsigned get_id(const std::shared_ptr<Meta>& config);
+        static const std::vector<std::string>& type_names() { return s_TypeNames; }
         static bool is_thing(std::string name);
         static std::shared_ptr<Thing> find_thing(Node* n);
 
 
         // Abstract Methods
         //virtual void lazy_logic_self(Freq::Time t) override;
-        //virtual void logic_self(Freq::Time t) override;
+        virtual void logic_self(Freq::Time t) override;
 
 
         // Setters
@@ -65,6 +68,8 @@ class Thing: public Node {
         void setup_player(const std::shared_ptr<Sprite>& player);
         void setup_map(const std::shared_ptr<TileMap>& map);
         void setup_other(const std::shared_ptr<Thing>& thing);
+        // end of the star pickup spiral
+        void collected();
 
 
         // Getters
@@ -73,16 +78,31 @@ class Thing: public Node {
         bool is_object() const { return m_ThingID >= OBJECTS && m_ThingID < OBJECTS_END; }
         bool is_marker() const { return m_ThingID >= MARKERS && m_ThingID < MARKERS_END; }
         bool solid() const { return m_Solid; }
+        // a collected star, its parent turns each step
+        bool spinning() const { return m_Spinning; }
         Freq::Timeline* timeline() const { return m_pTimeline; }
         Game* game() { return m_pGame; }
         Sprite* sprite() { return m_pSprite.get(); }
         MapTile* placeholder() { return m_pPlaceholder; }
+        const Colliders& colliders() const { return m_Colliders; }
 
 
         // Methods
         bool damage(int dmg);
-        void sound(const std::string& fn);
+        void sound(Mixer::Handle h);
+        // pickup burst where the item sits
+        void sparkle();
         void origin();
+
+        // sleeping things skip logic_self, Game decides
+        void sleep() { m_bAwake = false; }
+        void wake() { m_bAwake = true; }
+        bool awake() const { return m_bAwake; }
+
+        // Game's activation bookkeeping
+        glm::ivec2& cell() { return m_Cell; }
+        unsigned wake_frame() const { return m_WakeFrame; }
+        void wake_frame(unsigned f) { m_WakeFrame = f; }
         
         // Callbacks
         static void cb_to_bullet(Node* thing_node, Node* bullet);
@@ -99,6 +119,11 @@ class Thing: public Node {
         bool m_Dead = false;
         bool m_Solid = false;
         bool m_Active = false;
+        bool m_Spinning = false;
+        bool m_bAwake = true;
+        glm::ivec2 m_Cell;
+        unsigned m_WakeFrame = 0;
+        unsigned m_Light = ~0u; // baked, see Game::add_light()
 
         std::string m_Identity;
         glm::vec3 m_Impulse;
@@ -114,6 +139,8 @@ class Thing: public Node {
         
         // sprite is optional for thing type, not attached
         std::shared_ptr<Sprite> m_pSprite;
+        Colliders m_Colliders;
+        KinematicBody m_Body; // picked up things fly until they hit a wall
 };
 
 #endif
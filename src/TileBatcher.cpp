@@ -0,0 +1,87 @@
+#include "TileBatcher.h"
+#include <cmath>
+
+using namespace std;
+using namespace glm;
+
+
+TileBatcher :: TileBatcher(glm::vec2 tile_size, unsigned chunk_tiles):
+    m_ChunkSize(tile_size * (float)chunk_tiles)
+{}
+
+
+bool TileBatcher :: add(MapTile* tile) {
+    auto mesh = tile->mesh();
+    if (not mesh || not mesh->visible())
+        return false;
+
+    auto geometry = dynamic_pointer_cast<MeshGeometry>(mesh->geometry());
+    auto material = mesh->material();
+    if (not geometry || not material)
+        return false;
+
+    shared_ptr<Wrap> wrap;
+    for (auto&& m: mesh->internals()->mods)
+        if ((wrap = dynamic_pointer_cast<Wrap>(m)))
+            break;
+
+    auto& verts = geometry->verts();
+    if (not wrap || wrap->data().size() != verts.size())
+        return false;
+
+    // tiles are only translated and scaled (flips are in the wrap), so
+    // mapping the local box onto the world box places the vertices
+    Box local = mesh->box();
+    Box world = mesh->world_box();
+    vec3 lsize = local.size();
+    vec3 wsize = world.size();
+    vec3 scale(
+        lsize.x > K_EPSILON ? wsize.x / lsize.x : 1.0f,
+        lsize.y > K_EPSILON ? wsize.y / lsize.y : 1.0f,
+        lsize.z > K_EPSILON ? wsize.z / lsize.z : 1.0f
+    );
+
+    auto center = world.center();
+    auto key = Key(
+        (int)std::floor(center.x / m_ChunkSize.x),
+        (int)std::floor(center.y / m_ChunkSize.y),
+        material.get()
+    );
+
+    auto& chunk = m_Chunks[key];
+    if (not chunk.material) {
+        chunk.material = material;
+        chunk.box = world;
+    } else {
+        chunk.box.min() = glm::min(chunk.box.min(), world.min());
+        chunk.box.max() = glm::max(chunk.box.max(), world.max());
+    }
+
+    for (auto&& v: verts)
+        chunk.verts.push_back(world.min() + (v - local.min()) * scale);
+    chunk.wrap.insert(chunk.wrap.end(), wrap->data().begin(), wrap->data().end());
+
+    mesh->visible(false);
+    ++m_Tiles;
+    return true;
+}
+
+
+void TileBatcher :: bake(Node* parent, MaterialFunc material, bool unlit) {
+    for (auto&& c: m_Chunks) {
+        auto& chunk = c.second;
+        if (unlit)
+            for (auto&& w: chunk.wrap)
+                w.x += UNLIT_WRAP;
+        auto mesh = make_shared<Mesh>(
+            make_shared<MeshGeometry>(std::move(chunk.verts)),
+            vector<shared_ptr<IMeshModifier>>{
+                make_shared<Wrap>(std::move(chunk.wrap))
+            },
+            material ? material(chunk.material) : chunk.material
+        );
+        mesh->set_box(chunk.box);
+        parent->add(mesh);
+    }
+    m_Chunks.clear();
+}
@@ -0,0 +1,60 @@
+#ifndef TILEBATCHER_H_6DNC0VRK
+#define TILEBATCHER_H_6DNC0VRK
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "Qor/TileMap.h"
+#include "Qor/Mesh.h"
+
+// Merges the meshes of static map tiles into one mesh per chunk and tileset,
+// so a layer is drawn in tens of calls instead of one per tile.
+//
+// Tiles given to add() are hidden and must not change for the rest of the
+// level, so anything with its own behavior (things, monsters, spawns) has
+// to stay out.
+class TileBatcher {
+    public:
+        TileBatcher(glm::vec2 tile_size, unsigned chunk_tiles = 16);
+        ~TileBatcher() {}
+
+        // returns false if the tile's mesh can't be merged, it is left as is
+        bool add(MapTile* tile);
+
+        // chunk material from the tiles' material, e.g. a tinted copy
+        typedef std::function<
+            std::shared_ptr<MeshMaterial>(const std::shared_ptr<MeshMaterial>&)
+        > MaterialFunc;
+
+        // adds the chunk meshes to parent and clears the batcher.
+        // unlit chunks have their u shifted by UNLIT_WRAP, which the
+        // shaders read as "skip the lights, tint by the emissive color"
+        void bake(
+            Node* parent,
+            MaterialFunc material = MaterialFunc(),
+            bool unlit = false
+        );
+
+        static constexpr float UNLIT_WRAP = 2.0f;
+
+        unsigned tiles() const { return m_Tiles; }
+        unsigned chunks() const { return m_Chunks.size(); }
+
+    private:
+        struct Chunk {
+            std::shared_ptr<MeshMaterial> material;
+            std::vector<glm::vec3> verts;
+            std::vector<glm::vec2> wrap;
+            Box box;
+        };
+
+        typedef std::tuple<int, int, MeshMaterial*> Key;
+
+        glm::vec2 m_ChunkSize;
+        std::map<Key, Chunk> m_Chunks;
+        unsigned m_Tiles = 0;
+};
+
+#endif
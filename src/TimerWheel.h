@@ -0,0 +1,108 @@
+#ifndef TIMERWHEEL_H_N4HC8ZRA
+#define TIMERWHEEL_H_N4HC8ZRA
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timer wheel of plain records.  Each level has 64 slots, the
+// first one resolution seconds apart and every next one 64 times coarser,
+// so adding and expiring a timer is O(1) no matter how many are pending.
+// Records in a coarse slot are moved down a level as their time comes near.
+template<class T>
+class TimerWheel {
+    public:
+        TimerWheel(float resolution = 0.01f):
+            m_Resolution(resolution)
+        {}
+
+        float resolution() const { return m_Resolution; }
+        size_t size() const { return m_Size; }
+        bool empty() const { return m_Size == 0; }
+        uint64_t ticks() const { return m_Tick; }
+
+        // value expires delay seconds from now, at least one tick later
+        void add(float delay, T value) {
+            uint64_t ticks = (uint64_t)std::max(
+                std::ceil(delay / m_Resolution - 0.001f), 1.0f
+            );
+            insert(Entry{m_Tick + ticks, std::move(value)});
+            ++m_Size;
+        }
+
+        // calls func(T&) for every record that expires within t seconds,
+        // func may add new records
+        template<class Func>
+        void advance(float t, Func func) {
+            m_Accum += t;
+            while (m_Accum >= m_Resolution) {
+                m_Accum -= m_Resolution;
+                step(func);
+            }
+        }
+
+        void clear() {
+            for (auto&& level: m_Slots)
+                for (auto&& slot: level)
+                    slot.clear();
+            m_Size = 0;
+        }
+
+    private:
+        static const unsigned BITS = 6;
+        static const unsigned SLOTS = 1 << BITS;
+        static const unsigned LEVELS = 4;
+
+        struct Entry {
+            uint64_t expire;
+            T value;
+        };
+
+        void insert(Entry e) {
+            uint64_t diff = e.expire - m_Tick;
+            unsigned level = 0;
+            while (level < LEVELS - 1 && diff >= (uint64_t(1) << (BITS * (level + 1))))
+                ++level;
+            // further out than the top level spans, it lands back up there
+            // each time the slot comes around
+            auto slot = (e.expire >> (BITS * level)) & (SLOTS - 1);
+            m_Slots[level][slot].push_back(std::move(e));
+        }
+
+        template<class Func>
+        void step(Func& func) {
+            ++m_Tick;
+
+            // coarse slots whose span starts now move down, highest first
+            for (unsigned level = LEVELS - 1; level > 0; --level) {
+                if (m_Tick & ((uint64_t(1) << (BITS * level)) - 1))
+                    continue;
+                auto& slot = m_Slots[level][(m_Tick >> (BITS * level)) & (SLOTS - 1)];
+                m_Cascade.swap(slot);
+                for (auto&& e: m_Cascade)
+                    insert(std::move(e));
+                m_Cascade.clear();
+            }
+
+            auto& slot = m_Slots[0][m_Tick & (SLOTS - 1)];
+            if (slot.empty())
+                return;
+            m_Firing.swap(slot);
+            m_Size -= m_Firing.size();
+            for (auto&& e: m_Firing)
+                func(e.value);
+            m_Firing.clear();
+        }
+
+        float m_Resolution;
+        float m_Accum = 0.0f;
+        uint64_t m_Tick = 0;
+        size_t m_Size = 0;
+
+        std::vector<Entry> m_Slots[LEVELS][SLOTS];
+        std::vector<Entry> m_Cascade;
+        std::vector<Entry> m_Firing;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "VisibilityBaker.h"
+#include "Profiler.h"
+#include <cmath>
+
+using namespace std;
+using namespace glm;
+
+
+VisibilityBaker :: VisibilityBaker(glm::vec2 tile_size):
+    m_TileSize(tile_size)
+{}
+
+
+void VisibilityBaker :: camera(Node* camera, glm::vec2 view_size, glm::vec3 scale) {
+    m_pCamera = camera;
+    m_ViewSize = view_size;
+    m_Scale = scale;
+}
+
+
+void VisibilityBaker :: add(const std::shared_ptr<TileLayer>& layer, bool parallax) {
+    m_Layers.push_back(Entry{layer, ivec2(0), parallax, false});
+}
+
+
+bool VisibilityBaker :: update(Entry& e, glm::vec3 pos) {
+    auto cell = ivec2(
+        (int)std::floor(pos.x / m_TileSize.x),
+        (int)std::floor(pos.y / m_TileSize.y)
+    );
+    if (e.baked && cell == e.cell) {
+        ++m_Skips;
+        return false;
+    }
+
+    {
+        PROFILE_ZONE("bake_visible");
+        if (m_pCamera) {
+            // pos may be in the layer's space (parallax), move by the same
+            // amount in the camera's
+            auto old = m_pCamera->position();
+            auto shift = vec2(cell) * m_TileSize - vec2(pos);
+            m_pCamera->position(old + vec3(shift, 0.0f));
+            m_pCamera->rescale(m_Scale * vec3((m_ViewSize + m_TileSize) / m_ViewSize, 1.0f));
+            e.layer->bake_visible();
+            m_pCamera->rescale(m_Scale);
+            m_pCamera->position(old);
+        } else
+            e.layer->bake_visible();
+    }
+    e.cell = cell;
+    e.baked = true;
+    ++m_Bakes;
+    return true;
+}
+
+
+bool VisibilityBaker :: update(TileLayer* layer, glm::vec3 pos) {
+    for (auto&& e: m_Layers)
+        if (e.layer.get() == layer)
+            return update(e, pos);
+    return false;
+}
+
+
+void VisibilityBaker :: update(glm::vec3 pos) {
+    for (auto&& e: m_Layers)
+        if (not e.parallax)
+            update(e, pos);
+}
+
+
+void VisibilityBaker :: invalidate() {
+    for (auto&& e: m_Layers)
+        e.baked = false;
+}
@@ -0,0 +1,60 @@
+#ifndef VISIBILITYBAKER_H_Q2LM6ZUA
+#define VISIBILITYBAKER_H_Q2LM6ZUA
+
+#include <memory>
+#include <vector>
+#include "Qor/TileMap.h"
+
+// Rebakes a tile layer's visible set only when the camera crosses into
+// another tile cell, instead of on every camera movement.  Each bake
+// covers one extra tile of view (see camera()), so nothing is missing at
+// the edges while the camera moves inside the cell.
+class VisibilityBaker {
+    public:
+        VisibilityBaker(glm::vec2 tile_size = glm::vec2(16.0f));
+        ~VisibilityBaker() {}
+
+        void tile_size(glm::vec2 ts) { m_TileSize = ts; }
+
+        // the camera the layers bake through, which sees view_size world
+        // units at scale.  For a bake it is moved to the corner of the cell
+        // and zoomed out by a tile, then put back.
+        void camera(Node* camera, glm::vec2 view_size, glm::vec3 scale);
+
+        // parallax layers are baked explicitly when rendered,
+        // see update(layer, pos), the rest follow the camera
+        void add(const std::shared_ptr<TileLayer>& layer, bool parallax = false);
+
+        // bakes the layer if pos is in a different cell than its last bake,
+        // returns true if it baked
+        bool update(TileLayer* layer, glm::vec3 pos);
+
+        // update every non-parallax layer
+        void update(glm::vec3 pos);
+
+        // force the next update to bake
+        void invalidate();
+
+        unsigned bakes() const { return m_Bakes; }
+        unsigned skips() const { return m_Skips; }
+
+    private:
+        struct Entry {
+            std::shared_ptr<TileLayer> layer;
+            glm::ivec2 cell;
+            bool parallax;
+            bool baked;
+        };
+
+        bool update(Entry& e, glm::vec3 pos);
+
+        glm::vec2 m_TileSize;
+        Node* m_pCamera = nullptr;
+        glm::vec2 m_ViewSize;
+        glm::vec3 m_Scale;
+        std::vector<Entry> m_Layers;
+        unsigned m_Bakes = 0;
+        unsigned m_Skips = 0;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include <catch.hpp>
+#include "../src/CollisionGrid.h"
+
+using namespace std;
+using namespace glm;
+
+static Box tile_box(int x, int y) {
+    return Box(
+        vec3(x * 16.0f, y * 16.0f, -5.0f),
+        vec3((x + 1) * 16.0f, (y + 1) * 16.0f, 5.0f)
+    );
+}
+
+TEST_CASE("collision grid", "[CollisionGrid]") {
+    CollisionGrid grid(nullptr, vec2(16.0f, 16.0f));
+    grid.add(nullptr, tile_box(2, 3));
+    grid.add(nullptr, tile_box(4, 3), CollisionGrid::STATIC, tile_box(4, 3));
+    grid.add(nullptr, tile_box(5, 3), CollisionGrid::LEDGE, Box(
+        vec3(5 * 16.0f, 3 * 16.0f, -5.0f),
+        vec3(6 * 16.0f, 3 * 16.0f + 4.0f, 5.0f)
+    ));
+    grid.bake();
+
+    SECTION("cells"){
+        REQUIRE(grid.occupied(2, 3));
+        REQUIRE(grid.occupied(4, 3));
+        REQUIRE(not grid.occupied(3, 3));
+        REQUIRE(not grid.occupied(-100, 1000));
+        REQUIRE(grid.flags(4, 3) & CollisionGrid::STATIC);
+        REQUIRE(not (grid.flags(2, 3) & CollisionGrid::SOLID));
+    }
+
+    SECTION("queries"){
+        int hits = 0;
+        grid.each(Box(
+            vec3(4 * 16.0f + 2.0f, 3 * 16.0f + 2.0f, 0.0f),
+            vec3(4 * 16.0f + 6.0f, 3 * 16.0f + 6.0f, 1.0f)
+        ), CollisionGrid::SOLID, [&hits](const CollisionGrid::Cell&){
+            ++hits;
+        });
+        REQUIRE(hits == 1);
+
+        // below the ledge mask, inside the ledge cell
+        hits = 0;
+        grid.each(Box(
+            vec3(5 * 16.0f + 2.0f, 3 * 16.0f + 8.0f, 0.0f),
+            vec3(5 * 16.0f + 6.0f, 3 * 16.0f + 12.0f, 1.0f)
+        ), CollisionGrid::LEDGE, [&hits](const CollisionGrid::Cell&){
+            ++hits;
+        });
+        REQUIRE(hits == 0);
+    }
+}
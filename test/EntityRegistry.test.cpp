@@ -0,0 +1,50 @@
+#include <catch.hpp>
+#include <fstream>
+#include "../src/EntityRegistry.h"
+
+using namespace std;
+
+
+TEST_CASE("entity registry", "[EntityRegistry]") {
+    EntityRegistry reg;
+    auto duck = reg.add("duck", EntityRegistry::MONSTER, 1);
+    auto star = reg.add("star", EntityRegistry::THING, 3);
+
+    SECTION("names"){
+        REQUIRE(reg.find("") == 0);
+        REQUIRE(reg.find("nothing") == 0);
+        REQUIRE(reg[reg.find("spawn")].kind == EntityRegistry::SPAWN);
+        REQUIRE(reg.find("duck") == duck);
+        REQUIRE(reg[duck].id == 1);
+    }
+
+    SECTION("gids"){
+        reg.bind(70, "star", "gold");
+        reg.bind(72, "duck");
+        REQUIRE(reg.tile(70) == star);
+        REQUIRE(reg.tile(70 | EntityRegistry::FLIP_BITS) == star);
+        REQUIRE(reg.variant(70) == "gold");
+        REQUIRE(reg.tile(72) == duck);
+        REQUIRE(reg.variant(72).empty());
+        REQUIRE(reg.tile(71) == 0);
+        REQUIRE(reg.tile(100000) == 0);
+        reg.clear_tiles();
+        REQUIRE(reg.tile(70) == 0);
+    }
+
+    SECTION("data"){
+        string fn = "entities.test.json";
+        {
+            ofstream f(fn);
+            f << "{ \"goose\": { \"as\": \"duck\" },"
+                 "  \"coin\": { \"kind\": \"thing\", \"id\": 1 } }";
+        }
+        reg.load(fn);
+        remove(fn.c_str());
+
+        auto goose = reg.find("goose");
+        REQUIRE(reg[goose].kind == EntityRegistry::MONSTER);
+        REQUIRE(reg[goose].id == 1);
+        REQUIRE(reg[reg.find("coin")].kind == EntityRegistry::THING);
+    }
+}
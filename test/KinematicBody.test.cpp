@@ -0,0 +1,88 @@
+#include <catch.hpp>
+#include "../src/KinematicBody.h"
+
+using namespace std;
+using namespace glm;
+
+static Box tile_box(int x, int y) {
+    return Box(
+        vec3(x * 16.0f, y * 16.0f, -5.0f),
+        vec3((x + 1) * 16.0f, (y + 1) * 16.0f, 5.0f)
+    );
+}
+
+static Box body_box(float x, float y) {
+    return Box(vec3(x, y, -1.0f), vec3(x + 8.0f, y + 8.0f, 1.0f));
+}
+
+
+TEST_CASE("kinematic body", "[KinematicBody]") {
+    auto grid = make_shared<CollisionGrid>(nullptr, vec2(16.0f, 16.0f));
+    grid->add(nullptr, tile_box(4, 3), CollisionGrid::STATIC, tile_box(4, 3)); // wall
+    for (int x = 0; x < 4; ++x)
+        grid->add(nullptr, tile_box(x, 5), CollisionGrid::STATIC, tile_box(x, 5)); // floor
+    grid->add(nullptr, tile_box(8, 5), CollisionGrid::LEDGE, tile_box(8, 5));
+    grid->bake();
+    KinematicBody::Grids grids{grid};
+    KinematicBody body(&grids);
+
+    SECTION("stops at walls"){
+        auto r = body.sweep(body_box(40.0f, 52.0f), vec3(40.0f, 0.0f, 0.0f));
+        REQUIRE(r.blocked_x);
+        REQUIRE(not r.blocked_y);
+        REQUIRE(r.delta.x == Approx(16.0f));
+
+        // from the other side
+        r = body.sweep(body_box(84.0f, 52.0f), vec3(-8.0f, 0.0f, 0.0f));
+        REQUIRE(r.blocked_x);
+        REQUIRE(r.delta.x == Approx(-4.0f));
+
+        // stuck inside it, free to leave
+        r = body.sweep(body_box(70.0f, 52.0f), vec3(-8.0f, 0.0f, 0.0f));
+        REQUIRE(not r.blocked_x);
+    }
+
+    SECTION("lands and slides along floors"){
+        auto r = body.sweep(body_box(4.0f, 60.0f), vec3(6.0f, 30.0f, 0.0f));
+        REQUIRE(r.blocked_y);
+        REQUIRE(not r.blocked_x);
+        REQUIRE(r.delta.x == Approx(6.0f));
+        REQUIRE(r.delta.y == Approx(12.0f));
+
+        // resting on top, walking over the tile seams
+        r = body.sweep(body_box(4.0f, 72.0f), vec3(30.0f, 0.5f, 0.0f));
+        REQUIRE(not r.blocked_x);
+        REQUIRE(r.blocked_y);
+        REQUIRE(r.delta.y == Approx(0.0f));
+    }
+
+    SECTION("ledges only stop landing"){
+        auto r = body.sweep(body_box(132.0f, 70.0f), vec3(0.0f, 8.0f, 0.0f));
+        REQUIRE(r.blocked_y);
+        REQUIRE(r.delta.y == Approx(2.0f));
+
+        // jumping up through it, and walking into it from the side
+        r = body.sweep(body_box(132.0f, 100.0f), vec3(0.0f, -30.0f, 0.0f));
+        REQUIRE(not r.blocked_y);
+        r = body.sweep(body_box(116.0f, 84.0f), vec3(16.0f, 0.0f, 0.0f));
+        REQUIRE(not r.blocked_x);
+    }
+
+    SECTION("blockers outside the grids"){
+        // a door standing in the open above the floor
+        auto door = tile_box(2, 4);
+        auto r = body.sweep(body_box(10.0f, 68.0f), vec3(20.0f, 0.0f, 0.0f), &door);
+        REQUIRE(r.blocked_x);
+        REQUIRE(r.delta.x == Approx(14.0f));
+
+        // without it the way is clear
+        r = body.sweep(body_box(10.0f, 68.0f), vec3(20.0f, 0.0f, 0.0f));
+        REQUIRE(not r.blocked_x);
+
+        // and with no grids at all
+        KinematicBody lone(nullptr);
+        r = lone.sweep(body_box(10.0f, 68.0f), vec3(20.0f, 0.0f, 0.0f), &door);
+        REQUIRE(r.blocked_x);
+        REQUIRE(r.delta.x == Approx(14.0f));
+    }
+}
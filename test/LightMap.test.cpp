@@ -0,0 +1,34 @@
+#include <catch.hpp>
+#include "../src/LightMap.h"
+
+using namespace std;
+using namespace glm;
+
+
+TEST_CASE("light map", "[LightMap]") {
+    LightMap lm(2);
+    lm.resize(vec2(0.0f), vec2(160.0f, 80.0f), vec2(16.0f));
+    // plus the black border
+    REQUIRE(lm.size() == uvec2(22, 12));
+
+    auto red = lm.add(vec3(40.0f, 40.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), 32.0f);
+    lm.add(vec3(120.0f, 40.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), 32.0f);
+    lm.bake();
+    REQUIRE(lm.lights() == 2);
+
+    // brightest at the light, nothing past its distance
+    auto c = lm.sample(vec2(40.0f, 40.0f));
+    REQUIRE(c.x > 0.9f);
+    REQUIRE(c.z == 0.0f);
+    REQUIRE(lm.sample(vec2(56.0f, 40.0f)).x < c.x);
+    REQUIRE(lm.sample(vec2(80.0f, 40.0f)).x == 0.0f);
+    REQUIRE(lm.sample(vec2(120.0f, 40.0f)).z > 0.9f);
+    REQUIRE(lm.sample(vec2(-10.0f, 40.0f)).x == 0.0f);
+    REQUIRE(lm.sample(vec2(-4.0f, 40.0f)) == vec3(0.0f));
+
+    lm.enable(red, false);
+    REQUIRE(lm.sample(vec2(40.0f, 40.0f)).x == 0.0f);
+    REQUIRE(lm.sample(vec2(120.0f, 40.0f)).z > 0.9f);
+    lm.enable(red, true);
+    REQUIRE(lm.sample(vec2(40.0f, 40.0f)).x > 0.9f);
+}
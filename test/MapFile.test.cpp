@@ -0,0 +1,58 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include "../src/MapFile.h"
+
+using namespace std;
+
+TEST_CASE("map file", "[MapFile]") {
+    MapFile::Source src;
+    src.width = 3;
+    src.height = 2;
+
+    MapFile::Source::Layer bg;
+    bg.tiles = {1, 2, 0, 0, 3, 0};
+    bg.cells = {1, 1, 0, 0, 1, 0};
+    src.layers.push_back(bg);
+
+    MapFile::Source::Layer mid;
+    mid.tiles = {0, 0, 37, 40, 0, 67};
+    mid.cells = {
+        0, 0, MapFile::OCCUPIED | MapFile::FATAL,
+        MapFile::OCCUPIED | MapFile::LEDGE, 0, MapFile::OCCUPIED
+    };
+    src.layers.push_back(mid);
+
+    src.spawns.push_back(MapFile::Source::Spawn{67, "star", "gold"});
+
+    string fn = "mapfile_test.map";
+    MapFile::write(fn, src);
+
+    SECTION("read back"){
+        MapFile map(fn);
+        REQUIRE(map.width() == 3);
+        REQUIRE(map.height() == 2);
+        REQUIRE(map.layers() == 2);
+
+        REQUIRE(map.tiles(0)[4] == 3);
+        REQUIRE(map.cells(0)[4] == 1);
+
+        REQUIRE(map.tiles(1)[2] == 37);
+        REQUIRE(map.cells(1)[2] & MapFile::FATAL);
+        REQUIRE(map.cells(1)[3] & MapFile::LEDGE);
+
+        REQUIRE(map.spawns() == 1);
+        REQUIRE(map.spawn(0).gid == 67);
+        REQUIRE(strcmp(map.str(map.spawn(0).name), "star") == 0);
+        REQUIRE(strcmp(map.str(map.spawn(0).type), "gold") == 0);
+    }
+
+    SECTION("rejects other files"){
+        FILE* f = fopen(fn.c_str(), "r+b");
+        fputc('X', f);
+        fclose(f);
+        REQUIRE_THROWS(MapFile(fn));
+    }
+
+    remove(fn.c_str());
+}
@@ -0,0 +1,63 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "../src/Profiler.h"
+
+using namespace std;
+
+static void work() {
+    PROFILE_ZONE("work");
+    PROFILE_ZONE("inner");
+}
+
+
+TEST_CASE("profiler", "[Profiler]") {
+    SECTION("zones are no-ops without a profiler"){
+        REQUIRE(Profiler::current() == nullptr);
+        work();
+    }
+
+    SECTION("zones"){
+        Profiler prof(false);
+        REQUIRE(Profiler::current() == &prof);
+        REQUIRE(Profiler::zone("work") == Profiler::zone("work"));
+
+        prof.frame();
+        work();
+        work();
+        prof.frame();
+
+        auto stats = prof.stats();
+        bool found = false;
+        for (auto&& s: stats)
+            if (s.name == "work") {
+                found = true;
+                REQUIRE(s.calls == Approx(2.0f));
+                REQUIRE(s.cpu_ms >= 0.0f);
+            }
+        REQUIRE(found);
+        REQUIRE(prof.overlay().find("inner") != string::npos);
+    }
+
+    SECTION("trace"){
+        Profiler prof(false);
+        prof.capture(true);
+        prof.frame();
+        work();
+        prof.frame();
+        // two zones and the second frame
+        REQUIRE(prof.events() == 3);
+
+        string fn = "profiler.test.json";
+        prof.write_trace(fn);
+        ifstream f(fn);
+        stringstream ss;
+        ss << f.rdbuf();
+        auto s = ss.str();
+        REQUIRE(s.find("\"traceEvents\"") != string::npos);
+        REQUIRE(s.find("\"name\":\"inner\",\"ph\":\"X\"") != string::npos);
+        remove(fn.c_str());
+    }
+    REQUIRE(Profiler::current() == nullptr);
+}
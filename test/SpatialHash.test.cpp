@@ -0,0 +1,42 @@
+#include <catch.hpp>
+#include "../src/SpatialHash.h"
+
+using namespace std;
+using namespace glm;
+
+
+TEST_CASE("spatial hash", "[SpatialHash]") {
+    SpatialHash<int> hash(100.0f);
+    auto a = hash.cell(vec2(50.0f, 50.0f));
+    auto b = hash.cell(vec2(-250.0f, 50.0f));
+    hash.insert(1, a);
+    hash.insert(2, b);
+
+    auto count_near = [&hash](vec2 p, float r){
+        int n = 0;
+        hash.each_near(p, r, [&n](int){ ++n; });
+        return n;
+    };
+
+    SECTION("queries"){
+        REQUIRE(count_near(vec2(60.0f, 60.0f), 10.0f) == 1);
+        REQUIRE(count_near(vec2(-100.0f, 50.0f), 100.0f) == 1);
+        REQUIRE(count_near(vec2(-100.0f, 50.0f), 200.0f) == 2);
+        REQUIRE(count_near(vec2(1000.0f, 1000.0f), 100.0f) == 0);
+
+        int n = 0;
+        hash.each_in(vec2(-250.0f, 0.0f), vec2(-150.0f, 10.0f), [&n](int){ ++n; });
+        REQUIRE(n == 1);
+        hash.each_in(vec2(-250.0f, 0.0f), vec2(50.0f, 10.0f), [&n](int){ ++n; });
+        REQUIRE(n == 3);
+    }
+
+    SECTION("update"){
+        REQUIRE(not hash.update(1, a, vec2(90.0f, 10.0f)));
+        REQUIRE(hash.update(1, a, vec2(1050.0f, 10.0f)));
+        REQUIRE(count_near(vec2(50.0f, 50.0f), 10.0f) == 0);
+        REQUIRE(count_near(vec2(1050.0f, 50.0f), 10.0f) == 1);
+        hash.remove(1, a);
+        REQUIRE(count_near(vec2(1050.0f, 50.0f), 10.0f) == 0);
+    }
+}
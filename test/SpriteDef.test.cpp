@@ -0,0 +1,81 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include "../src/SpriteDef.h"
+#include "../src/SpriteStates.h"
+
+using namespace std;
+using namespace glm;
+
+TEST_CASE("sprite definitions", "[SpriteDef]") {
+    string fn = "spritedef_test.json";
+    {
+        ofstream f(fn);
+        f << R"({
+            "size": [32, 16],
+            "origin": [0.5, 0.8],
+            "mask": [0.1, 0.0, 0.8, 0.9],
+            "animation": {
+                "speed": 12.0,
+                "frames": {
+                    "forward": {
+                        "left": { "walk": ["hflip", 0, 1, 0, 2] },
+                        "right": { "walk": [0, 1, 0, 2] }
+                    }
+                }
+            },
+            "hp": 20
+        })";
+    }
+
+    SECTION("parse"){
+        auto def = SpriteDef::load(fn);
+        REQUIRE(def->size == vec2(32.0f, 16.0f));
+        REQUIRE(def->tile_size == def->size);
+        REQUIRE(def->mask.max().x == Approx(0.8f));
+        REQUIRE(def->hp == 20);
+        REQUIRE(def->speed == Approx(10.0f));
+        REQUIRE(def->animation_speed == Approx(12.0f));
+
+        auto walk = def->animation("forward.left.walk");
+        REQUIRE(walk);
+        REQUIRE(walk->hflip);
+        REQUIRE(walk->frames.size() == 4);
+        REQUIRE(not def->animation("forward.left"));
+    }
+
+    SECTION("states"){
+        shared_ptr<const SpriteDef> def = SpriteDef::load(fn);
+        REQUIRE(def->categories() == 3);
+        REQUIRE(def->category(def->state("forward")) == 0);
+        REQUIRE(def->category(def->state("right")) == 1);
+        REQUIRE(def->category(def->state("walk")) == 2);
+        REQUIRE(def->state("jump") == SpriteDef::NO_STATE);
+
+        SpriteStates states(def);
+        states.init({"walk", "right", "forward"});
+        REQUIRE(not states.dirty());
+        REQUIRE(states.is(states.id("right")));
+        REQUIRE(not states.animation()->hflip);
+
+        states.set(states.id("right"));
+        REQUIRE(not states.dirty());
+        states.set(states.id("left"));
+        REQUIRE(states.dirty());
+        REQUIRE(not states.is(states.id("right")));
+        REQUIRE(states.animation() == def->animation("forward.left.walk"));
+    }
+
+    SECTION("cache"){
+        SpriteDefCache cache;
+        auto a = cache.get(fn);
+        auto b = cache.get(fn);
+        REQUIRE(a);
+        REQUIRE(a == b);
+        REQUIRE(cache.misses() == 1);
+        REQUIRE(cache.hits() == 1);
+        REQUIRE(not cache.get("missing.json"));
+    }
+
+    remove(fn.c_str());
+}
@@ -0,0 +1,54 @@
+#include <catch.hpp>
+#include <vector>
+#include "../src/TimerWheel.h"
+
+using namespace std;
+
+
+TEST_CASE("timer wheel", "[TimerWheel]") {
+    TimerWheel<int> wheel(0.01f);
+    vector<pair<int, uint64_t>> fired;
+    auto record = [&](int& v){
+        fired.push_back(make_pair(v, wheel.ticks()));
+    };
+
+    SECTION("expiry"){
+        wheel.add(0.05f, 1);
+        wheel.add(0.0f, 2);
+        wheel.add(1.0f, 3); // past the first level
+        wheel.add(100.0f, 4); // past two levels
+        REQUIRE(wheel.size() == 4);
+
+        wheel.advance(0.01f, record);
+        REQUIRE(fired.size() == 1);
+        REQUIRE(fired[0] == make_pair(2, uint64_t(1)));
+
+        wheel.advance(0.04f, record);
+        REQUIRE(fired.size() == 2);
+        REQUIRE(fired[1] == make_pair(1, uint64_t(5)));
+
+        for (int i = 0; i < 100; ++i)
+            wheel.advance(0.01f, record);
+        REQUIRE(fired.size() == 3);
+        REQUIRE(fired[2] == make_pair(3, uint64_t(100)));
+
+        wheel.advance(99.0f, record);
+        REQUIRE(fired.size() == 4);
+        REQUIRE(fired[3].first == 4);
+        REQUIRE(fired[3].second >= 9999);
+        REQUIRE(fired[3].second <= 10001);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("rescheduling"){
+        int count = 0;
+        wheel.add(0.05f, 0);
+        wheel.advance(1.0f, [&](int& v){
+            ++count;
+            if (v < 3)
+                wheel.add(0.05f, v + 1);
+        });
+        REQUIRE(count == 4);
+        REQUIRE(wheel.empty());
+    }
+}
@@ -0,0 +1,212 @@
+// mapc: compiles a .tmx map and its tileset json into a .map file
+//   mapc <in.tmx> <out.map>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <json/json.h>
+#include <rapidxml.hpp>
+#include "../../src/MapFile.h"
+
+using namespace std;
+using namespace rapidxml;
+
+namespace {
+    const uint32_t FLIP_BITS = 0xe0000000;
+
+    typedef map<string, string> Properties;
+
+    struct Tileset {
+        uint32_t firstgid = 1;
+        uint32_t columns = 1;
+        map<uint32_t, Properties> tiles; // by local id
+    };
+
+    void fail(const string& msg) {
+        cerr << "mapc: " << msg << endl;
+        exit(1);
+    }
+
+    string dir_of(const string& fn) {
+        auto i = fn.find_last_of("/\\");
+        return i == string::npos ? string() : fn.substr(0, i + 1);
+    }
+
+    string read_file(const string& fn) {
+        ifstream f(fn, ios::binary);
+        if (not f)
+            fail("can't read " + fn);
+        stringstream ss;
+        ss << f.rdbuf();
+        return ss.str();
+    }
+
+    string attr(xml_node<>* node, const char* name, const string& def = "") {
+        auto a = node->first_attribute(name);
+        return a ? string(a->value()) : def;
+    }
+
+    Properties properties(xml_node<>* node) {
+        Properties r;
+        auto props = node->first_node("properties");
+        if (not props)
+            return r;
+        for (auto p = props->first_node("property"); p; p = p->next_sibling("property"))
+            r[attr(p, "name")] = attr(p, "value");
+        return r;
+    }
+
+    // tileset.png -> tileset.json, keyed by "column,row"
+    void load_json(Tileset& ts, const string& fn) {
+        ifstream f(fn);
+        if (not f)
+            return;
+
+        Json::Value root;
+        Json::Reader reader;
+        if (not reader.parse(f, root))
+            fail("can't parse " + fn);
+
+        for (auto&& key: root.getMemberNames()) {
+            unsigned x = 0, y = 0;
+            char comma;
+            istringstream ss(key);
+            if (not (ss >> x >> comma >> y))
+                fail(fn + ": bad tile key " + key);
+
+            auto& props = ts.tiles[y * ts.columns + x];
+            auto& tile = root[key];
+            for (auto&& name: tile.getMemberNames())
+                props[name] = tile[name].asString();
+        }
+    }
+
+    const Properties* tile_properties(const vector<Tileset>& tilesets, uint32_t gid) {
+        gid &= ~FLIP_BITS;
+        const Tileset* ts = nullptr;
+        for (auto&& t: tilesets)
+            if (t.firstgid <= gid && (not ts || t.firstgid > ts->firstgid))
+                ts = &t;
+        if (not ts)
+            return nullptr;
+
+        auto itr = ts->tiles.find(gid - ts->firstgid);
+        return itr == ts->tiles.end() ? nullptr : &itr->second;
+    }
+}
+
+
+int main(int argc, const char** argv) {
+    if (argc != 3) {
+        cerr << "usage: mapc <in.tmx> <out.map>" << endl;
+        return 1;
+    }
+    string in = argv[1];
+    string dir = dir_of(in);
+
+    auto text = read_file(in);
+    xml_document<> doc;
+    try {
+        doc.parse<0>(&text[0]);
+    } catch (const parse_error& e) {
+        fail(in + ": " + e.what());
+    }
+
+    auto root = doc.first_node("map");
+    if (not root)
+        fail(in + ": no map");
+
+    MapFile::Source src;
+    src.width = atoi(attr(root, "width").c_str());
+    src.height = atoi(attr(root, "height").c_str());
+    src.tile_width = atoi(attr(root, "tilewidth", "16").c_str());
+    src.tile_height = atoi(attr(root, "tileheight", "16").c_str());
+    const uint32_t cells = src.width * src.height;
+
+    // tile properties come from the json next to the tileset image,
+    // with the ones set in the tmx on top
+    vector<Tileset> tilesets;
+    for (auto t = root->first_node("tileset"); t; t = t->next_sibling("tileset")) {
+        Tileset ts;
+        ts.firstgid = atoi(attr(t, "firstgid", "1").c_str());
+        ts.columns = std::max(1, atoi(attr(t, "columns", "1").c_str()));
+
+        if (auto image = t->first_node("image")) {
+            auto source = attr(image, "source");
+            load_json(ts, dir + source.substr(0, source.find_last_of('.')) + ".json");
+        }
+        for (auto tile = t->first_node("tile"); tile; tile = tile->next_sibling("tile")) {
+            auto& props = ts.tiles[atoi(attr(tile, "id").c_str())];
+            for (auto&& p: properties(tile))
+                props[p.first] = p.second;
+        }
+        tilesets.push_back(ts);
+    }
+
+    map<uint32_t, bool> spawned; // gids already in src.spawns
+    for (auto l = root->first_node("layer"); l; l = l->next_sibling("layer")) {
+        MapFile::Source::Layer layer;
+        auto name = attr(l, "name");
+        auto props = properties(l);
+        bool parallax = props.count("parallax");
+        bool depth = props.count("depth");
+
+        auto data = l->first_node("data");
+        if (not data || attr(data, "encoding") != "csv")
+            fail(in + ": layer " + name + " is not csv encoded");
+
+        istringstream csv(data->value());
+        string gid;
+        while (getline(csv, gid, ','))
+            layer.tiles.push_back(strtoul(gid.c_str(), nullptr, 10));
+        if (layer.tiles.size() != cells)
+            fail(in + ": layer " + name + " has the wrong size");
+
+        // same rules as Game::preload()
+        layer.cells.resize(cells, 0);
+        for (uint32_t i = 0; i < cells; ++i) {
+            uint32_t g = layer.tiles[i];
+            if (not g)
+                continue;
+
+            uint8_t flags = MapFile::OCCUPIED;
+            auto tp = tile_properties(tilesets, g);
+            if (tp && tp->count("name")) {
+                auto type = tp->find("type");
+                if (not spawned[g])
+                    src.spawns.push_back(MapFile::Source::Spawn{
+                        g,
+                        tp->at("name"),
+                        type == tp->end() ? string() : type->second
+                    });
+                spawned[g] = true;
+            } else if (not parallax &&
+                (depth || (tp && tp->count("depth")))
+            ) {
+                if (tp && tp->count("fatal"))
+                    flags |= MapFile::FATAL;
+                else if (tp && tp->count("ledge"))
+                    flags |= MapFile::LEDGE;
+                else
+                    flags |= MapFile::STATIC;
+            }
+            layer.cells[i] = flags;
+        }
+
+        src.layers.push_back(std::move(layer));
+    }
+
+    try {
+        MapFile::write(argv[2], src);
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+
+    cout << argv[2] << ": " << src.layers.size() << " layers, "
+        << src.spawns.size() << " spawns" << endl;
+    return 0;
+}